@@ -1,10 +1,15 @@
 #include "client-face.hpp"
+#include "signing-pool.hpp"
 #include "util/logger.hpp"
 
 namespace ndn {
 
 ClientFace::ClientFace()
   : shouldNackUnmatchedInterest(false)
+  , shouldEncodeNackAsLpPacket(false)
+  , signingPool(nullptr)
+  , shouldAggregateInterests(false)
+  , m_requestCounters()
 {
 }
 
@@ -19,25 +24,50 @@ ClientFace::listen(const Name& prefix, const OnInterest& onInterest, bool wantRe
     this->registerPrefix(prefix);
   }
 
-  m_listeners.push_back(Listener());
-  Listener& listener = m_listeners.back();
-  listener.prefix = prefix;
-  listener.onInterest = onInterest;
+  m_listeners.insert(prefix, onInterest);
+}
+
+void
+ClientFace::unlisten(const Name& prefix)
+{
+  m_listeners.erase(prefix);
 }
 
 void
 ClientFace::reply(const Interest& interest, const Data& data)
 {
   if (!data.getSignature()) {
-    // add fake signature
-    ndn::SignatureSha256WithRsa fakeSignature;
-    fakeSignature.setValue(ndn::dataBlock(tlv::SignatureValue,
-                                          static_cast<const uint8_t*>(nullptr), 0));
-    const_cast<Data&>(data).setSignature(fakeSignature);
+    if (signingPool != nullptr) {
+      signingPool->submit(data, bind(&ClientFace::sendReply, this, interest, _1));
+      return;
+    }
+
+    DataTemplate::addFakeSignature(const_cast<Data&>(data));
   }
 
+  this->sendReply(interest, data);
+}
+
+void
+ClientFace::sendReply(const Interest& interest, const Data& data)
+{
   this->sendData(data);
   this->trace(TraceEventKind::DATA_TO, interest, Nack::NONE);
+
+  if (m_replyCache.isEnabled()) {
+    m_replyCache.insert(data);
+  }
+}
+
+void
+ClientFace::reply(const Interest& interest, const DataTemplate& dataTemplate, const Name& name)
+{
+  this->sendElement(dataTemplate.encodeHeader(name), dataTemplate.getTail());
+  this->trace(TraceEventKind::DATA_TO, interest, Nack::NONE);
+
+  if (m_replyCache.isEnabled()) {
+    m_replyCache.insert(dataTemplate.makeData(name));
+  }
 }
 
 void
@@ -48,27 +78,86 @@ ClientFace::reply(const Interest& interest, const Nack& nack)
 }
 
 void
-ClientFace::onInterestTimeout(PendingInterestList::iterator it)
+ClientFace::onInterestTimeout(PendingInterestTable::iterator it)
 {
-  this->trace(TraceEventKind::TIMEOUT_FROM, it->interest, Nack::NONE);
-  if (it->onTimeout) {
-    it->onTimeout(it->interest);
+  // invoke callback after PI is deleted from m_pendingInterests,
+  // otherwise a retransmission could be aggregated onto the expiring PI
+  PendingInterestTable::EntryList expired;
+  m_pendingInterests.extract(it, expired);
+  PendingInterestTable::Entry& pi = expired.front();
+
+  if (pi.isRateControlled) {
+    RateController::Flow* flow = m_rateController.findFlow(pi.interest.getName());
+    if (flow != nullptr) {
+      m_rateController.onTimeout(*flow, pi.sendTime);
+    }
+  }
+
+  this->trace(TraceEventKind::TIMEOUT_FROM, pi.interest, Nack::NONE);
+  if (pi.onTimeout) {
+    pi.onTimeout(pi.interest);
+  }
+  for (auto&& follower : pi.followers) {
+    if (follower.onTimeout) {
+      follower.onTimeout(follower.interest);
+    }
+  }
+  m_pendingInterests.recycle(expired);
+
+  if (m_rateController.isEnabled()) {
+    this->sendQueuedRequests();
   }
-  m_pendingInterests.erase(it);
 }
 
 void
 ClientFace::request(const Interest& interest, const OnData& onData,
                          const OnNack& onNack, const OnTimeout& onTimeout,
-                         const time::milliseconds& timeoutOverride)
+                         const time::milliseconds& timeoutOverride,
+                         bool isRetransmission)
 {
-  PendingInterestList::iterator it = m_pendingInterests.insert(m_pendingInterests.end(),
-                                                               PendingInterest());
-  PendingInterest& pi = *it;
-  pi.interest = interest;
+  ++m_requestCounters.nRequests;
+  if (this->shouldAggregateInterests) {
+    PendingInterestTable::Entry* leader = m_pendingInterests.findSameInterest(interest);
+    if (leader != nullptr) {
+      ++m_requestCounters.nAggregated;
+      leader->followers.push_back({interest, onData, onNack, onTimeout});
+      return;
+    }
+  }
+
+  bool isRateControlled = false;
+  if (m_rateController.isEnabled()) {
+    RateController::Flow* flow = m_rateController.findFlow(interest.getName());
+    if (flow != nullptr) {
+      if (!flow->queue.empty() || !m_rateController.canSend(*flow)) {
+        ++flow->nQueued;
+        flow->queue.push_back({interest, onData, onNack, onTimeout,
+                               timeoutOverride, isRetransmission});
+        return;
+      }
+      m_rateController.onSend(*flow);
+      isRateControlled = true;
+    }
+  }
+
+  this->sendRequest(interest, onData, onNack, onTimeout,
+                    timeoutOverride, isRetransmission, isRateControlled);
+}
+
+void
+ClientFace::sendRequest(const Interest& interest, const OnData& onData,
+                        const OnNack& onNack, const OnTimeout& onTimeout,
+                        const time::milliseconds& timeoutOverride,
+                        bool isRetransmission, bool isRateControlled)
+{
+  PendingInterestTable::iterator it = m_pendingInterests.insert(interest);
+  PendingInterestTable::Entry& pi = *it;
   pi.onData = onData;
   pi.onNack = onNack;
   pi.onTimeout = onTimeout;
+  pi.sendTime = time::steady_clock::now();
+  pi.isRetransmission = isRetransmission;
+  pi.isRateControlled = isRateControlled;
 
   time::milliseconds timeout = interest.getInterestLifetime();
   if (timeout < time::milliseconds::zero()) {
@@ -79,17 +168,39 @@ ClientFace::request(const Interest& interest, const OnData& onData,
     //     so that caller doesn't have to manage retx
     timeout = timeoutOverride;
   }
+  // capturing only this and it keeps the callback within std::function's inline storage
   pi.timeoutEvent = this->getScheduler().schedule(timeout,
-                    bind(&ClientFace::onInterestTimeout, this, it));
+                    [this, it] { this->onInterestTimeout(it); });
 
   this->sendInterest(interest);
   this->trace(TraceEventKind::INTEREST_TO, interest, Nack::NONE);
 }
 
+void
+ClientFace::sendQueuedRequests()
+{
+  for (RateController::Flow& flow : m_rateController) {
+    while (!flow.queue.empty() && m_rateController.canSend(flow)) {
+      RateController::QueuedRequest req = std::move(flow.queue.front());
+      flow.queue.pop_front();
+      m_rateController.onSend(flow);
+      this->sendRequest(req.interest, req.onData, req.onNack, req.onTimeout,
+                        req.timeoutOverride, req.isRetransmission, true);
+    }
+  }
+}
+
 void
 ClientFace::receiveElement(const Block& block)
 {
-  if (block.type() == tlv::Interest) {
+  // LpPacket is recognized by TLV-TYPE, without decoding as Interest
+  if (block.type() == Nack::TLV_LP_PACKET) {
+    Nack nack;
+    if (nack.decodeLp(block)) {
+      this->receiveNack(nack);
+    }
+  }
+  else if (block.type() == tlv::Interest) {
     Interest interest(block);
 
     Nack nack;
@@ -115,12 +226,22 @@ void
 ClientFace::receiveInterest(const Interest& interest)
 {
   this->trace(TraceEventKind::INTEREST_FROM, interest, Nack::NONE);
-  for (Listener& listener : m_listeners) {
-    if (listener.prefix.isPrefixOf(interest.getName())) {
-      listener.onInterest(listener.prefix, interest);
+  if (m_replyCache.isEnabled()) {
+    const Data* data = m_replyCache.find(interest);
+    if (data != nullptr) {
+      this->sendData(*data);
+      this->trace(TraceEventKind::DATA_TO, interest, Nack::NONE);
       return;
     }
   }
+
+  // listener is held during the callback, which may listen or unlisten
+  shared_ptr<const ListenerTable::Listener> listener =
+    m_listeners.findLongestPrefixMatch(interest.getName());
+  if (listener != nullptr) {
+    listener->onInterest(listener->prefix, interest);
+    return;
+  }
   if (this->shouldNackUnmatchedInterest) {
     this->reply(interest, Nack(Nack::NODATA, interest));
   }
@@ -129,46 +250,72 @@ ClientFace::receiveInterest(const Interest& interest)
 void
 ClientFace::receiveData(const Data& data)
 {
-  PendingInterestList satisfied;
-  m_pendingInterests.remove_if([&] (PendingInterest& pi) -> bool {
-    if (!pi.interest.matchesData(data)) {
-      return false;
-    }
+  PendingInterestTable::EntryList satisfied;
+  m_pendingInterests.extractDataMatches(data, satisfied);
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  for (auto&& pi : satisfied) {
     this->getScheduler().cancel(pi.timeoutEvent);
-    if (static_cast<bool>(pi.onData)) {
-      satisfied.push_back(pi);
+    if (!pi.isRetransmission) {
+      m_rttEstimator.addMeasurement(now - pi.sendTime);
     }
-    return true;
-  });
+    if (pi.isRateControlled) {
+      RateController::Flow* flow = m_rateController.findFlow(pi.interest.getName());
+      if (flow != nullptr) {
+        m_rateController.onData(*flow);
+      }
+    }
+  }
 
+  // invoke callback after PI is deleted from m_pendingInterests,
+  // otherwise if callback expresses new Interest, it could be matched again
   for (auto&& pi : satisfied) {
-    this->trace(TraceEventKind::DATA_FROM, pi.interest, Nack::NONE);
-    pi.onData(pi.interest, const_cast<Data&>(data));
+    if (static_cast<bool>(pi.onData)) {
+      this->trace(TraceEventKind::DATA_FROM, pi.interest, Nack::NONE);
+      pi.onData(pi.interest, const_cast<Data&>(data));
+    }
+    for (auto&& follower : pi.followers) {
+      if (static_cast<bool>(follower.onData)) {
+        follower.onData(follower.interest, const_cast<Data&>(data));
+      }
+    }
+  }
+  m_pendingInterests.recycle(satisfied);
+
+  if (m_rateController.isEnabled()) {
+    this->sendQueuedRequests();
   }
 }
 
 void
 ClientFace::receiveNack(const Nack& nack)
 {
-  const Interest& i1 = nack.getInterest();
-  PendingInterestList satisfied;
-  m_pendingInterests.remove_if([&] (PendingInterest& pi) -> bool {
-    const Interest& i2 = pi.interest;
-    if (i1.getName() == i2.getName() && i1.getSelectors() == i2.getSelectors()) {
-      this->getScheduler().cancel(pi.timeoutEvent);
-      if (static_cast<bool>(pi.onNack)) {
-        satisfied.push_back(pi);
+  PendingInterestTable::EntryList satisfied;
+  m_pendingInterests.extractNackMatches(nack.getInterest(), satisfied);
+  for (auto&& pi : satisfied) {
+    this->getScheduler().cancel(pi.timeoutEvent);
+    if (pi.isRateControlled) {
+      RateController::Flow* flow = m_rateController.findFlow(pi.interest.getName());
+      if (flow != nullptr) {
+        m_rateController.onNack(*flow, nack, pi.sendTime);
       }
-      return true;
     }
-    return false;
-  });
+  }
 
-  // invoke callback after PI is deleted from m_pendingInterests,
-  // otherwise if callback expresses new Interest, remove_if would be affected
   for (auto&& pi : satisfied) {
-    this->trace(TraceEventKind::NACK_FROM, pi.interest, nack.getCode());
-    pi.onNack(pi.interest, nack);
+    if (static_cast<bool>(pi.onNack)) {
+      this->trace(TraceEventKind::NACK_FROM, pi.interest, nack.getCode());
+      pi.onNack(pi.interest, nack);
+    }
+    for (auto&& follower : pi.followers) {
+      if (static_cast<bool>(follower.onNack)) {
+        follower.onNack(follower.interest, nack);
+      }
+    }
+  }
+  m_pendingInterests.recycle(satisfied);
+
+  if (m_rateController.isEnabled()) {
+    this->sendQueuedRequests();
   }
 }
 
@@ -187,7 +334,12 @@ ClientFace::sendData(const Data& data)
 void
 ClientFace::sendNack(const Nack& nack)
 {
-  this->sendInterestOrNack(nack.encode());
+  if (this->shouldEncodeNackAsLpPacket) {
+    this->sendElement(nack.encodeLpHeader(), nack.getInterest().wireEncode());
+  }
+  else {
+    this->sendInterestOrNack(nack.encode());
+  }
 }
 
 void
@@ -203,4 +355,45 @@ ClientFace::sendElement(const Block& block)
                        // or sendInterest+sendData+sendNack
 }
 
+void
+ClientFace::sendElement(const Block& header, const Block& payload)
+{
+  auto buffer = make_shared<Buffer>(header.size() + payload.size());
+  std::copy(header.wire(), header.wire() + header.size(), buffer->begin());
+  std::copy(payload.wire(), payload.wire() + payload.size(), buffer->begin() + header.size());
+  this->sendElement(Block(buffer));
+}
+
+std::ostream&
+operator<<(std::ostream& os, ClientFace::TraceEventKind evt)
+{
+  switch (evt) {
+  case ClientFace::TraceEventKind::INTEREST_TO:
+    os << "interestTo";
+    break;
+  case ClientFace::TraceEventKind::DATA_FROM:
+    os << "dataFrom";
+    break;
+  case ClientFace::TraceEventKind::NACK_FROM:
+    os << "nackFrom";
+    break;
+  case ClientFace::TraceEventKind::TIMEOUT_FROM:
+    os << "timeoutFrom";
+    break;
+  case ClientFace::TraceEventKind::INTEREST_FROM:
+    os << "interestFrom";
+    break;
+  case ClientFace::TraceEventKind::DATA_TO:
+    os << "dataTo";
+    break;
+  case ClientFace::TraceEventKind::NACK_TO:
+    os << "nackTo";
+    break;
+  default:
+    os << static_cast<int>(evt);
+    break;
+  }
+  return os;
+}
+
 } // namespace ndn
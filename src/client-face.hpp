@@ -1,15 +1,18 @@
 #ifndef NDNCXXEXT_CLIENT_FACE_HPP
 #define NDNCXXEXT_CLIENT_FACE_HPP
 
-#include "nack.hpp"
-#include "util/scheduler.hpp"
-#include <list>
-#include <ndn-cxx/face.hpp>
+#include "pending-interest-table.hpp"
+#include "listener-table.hpp"
+#include "data-template.hpp"
+#include "reply-cache.hpp"
+#include "rate-controller.hpp"
+#include "util/memory-pool.hpp"
+#include "util/rtt-estimator.hpp"
 #include <ndn-cxx/util/signal.hpp>
 
 namespace ndn {
 
-typedef function<void(const Interest&, const Nack&)> OnNack;
+class SigningPool;
 
 /** \brief NACK-enabled client face
  */
@@ -25,12 +28,31 @@ public:
   getScheduler() = 0;
 
 public: // producer
+  /** \brief dispatch Interests under \p prefix to \p onInterest
+   *
+   *  An Interest is dispatched to the listener with longest matching prefix.
+   *  Listening on a prefix again replaces the previous callback.
+   */
   void
   listen(const Name& prefix, const OnInterest& onInterest, bool wantRegister = true);
 
+  /** \brief stop dispatching Interests under \p prefix
+   *
+   *  This does not unregister the prefix from the forwarder.
+   */
+  void
+  unlisten(const Name& prefix);
+
   void
   reply(const Interest& interest, const Data& data);
 
+  /** \brief reply with a Data made from \p dataTemplate and \p name
+   *
+   *  Only the header containing \p name is encoded; the template tail is sent without copying.
+   */
+  void
+  reply(const Interest& interest, const DataTemplate& dataTemplate, const Name& name);
+
   void
   reply(const Interest& interest, const Nack& nack);
 
@@ -38,11 +60,101 @@ public: // producer
    */
   bool shouldNackUnmatchedInterest;
 
+  /** \brief whether to send NACK as LpPacket instead of name-based encoding
+   *
+   *  Incoming NACK is accepted in either encoding.
+   */
+  bool shouldEncodeNackAsLpPacket;
+
+  /** \brief cache of Data sent by reply()
+   *
+   *  The cache is disabled until given a capacity. When enabled, an incoming Interest
+   *  satisfied by a cached Data is answered from the cache, without reaching the listener.
+   */
+  ReplyCache&
+  getReplyCache()
+  {
+    return m_replyCache;
+  }
+
+  /** \brief if not nullptr, Data passed to reply() without a signature is signed by this pool,
+   *         and sent after signing completes
+   *
+   *  Otherwise, such Data is sent with a fake signature.
+   */
+  SigningPool* signingPool;
+
 public: // consumer
+  /** \param isRetransmission whether \p interest retransmits an earlier request;
+   *         RTT of a retransmitted request is not measured
+   *
+   *  If the Interest is under a prefix enabled in getRateController() and its window is full,
+   *  the request is queued, and its timeout starts when it is sent.
+   */
   void
   request(const Interest& interest, const OnData& onData,
           const OnNack& onNack, const OnTimeout& onTimeout,
-          const time::milliseconds& timeoutOverride = time::milliseconds::min());
+          const time::milliseconds& timeoutOverride = time::milliseconds::min(),
+          bool isRetransmission = false);
+
+  /** \brief RTT estimator of this face
+   *
+   *  It measures the time from sending an Interest to receiving its Data,
+   *  for requests that are not retransmissions.
+   */
+  util::RttEstimator&
+  getRttEstimator()
+  {
+    return m_rttEstimator;
+  }
+
+  /** \brief whether to aggregate requests
+   *
+   *  When enabled, a request with same Name and Selectors as an outstanding request
+   *  is not sent. Its callbacks are attached to the outstanding request, and invoked
+   *  upon Data, NACK, or timeout of that request; its own timeout is not used.
+   */
+  bool shouldAggregateInterests;
+
+  /** \brief congestion control of requests
+   *
+   *  The controller is disabled until a prefix is enabled.
+   */
+  RateController&
+  getRateController()
+  {
+    return m_rateController;
+  }
+
+  struct RequestCounters
+  {
+    uint64_t nRequests; ///< requests, including aggregated requests
+    uint64_t nAggregated; ///< requests aggregated onto an outstanding request
+  };
+
+  const RequestCounters&
+  getRequestCounters() const
+  {
+    return m_requestCounters;
+  }
+
+public: // allocation
+  /** \brief pool for per-request state objects, such as those of util::requestAutoRetry
+   */
+  util::MemoryPool&
+  getRequestPool()
+  {
+    return m_requestPool;
+  }
+
+  /** \return number of pending Interest entries obtained from the system;
+   *          entries are recycled, so this stays constant in steady state
+   */
+  size_t
+  getNAllocatedPendingInterests() const
+  {
+    return m_pendingInterests.getNAllocatedEntries();
+  }
 
 public: // trace
   enum class TraceEventKind {
@@ -74,6 +186,24 @@ protected: // receive path
   receiveNack(const Nack& nack);
 
 private: // send path
+  /** \brief inserts a pending Interest entry and sends \p interest
+   */
+  void
+  sendRequest(const Interest& interest, const OnData& onData,
+              const OnNack& onNack, const OnTimeout& onTimeout,
+              const time::milliseconds& timeoutOverride,
+              bool isRetransmission, bool isRateControlled);
+
+  /** \brief sends queued requests that fit in the window of their flows
+   */
+  void
+  sendQueuedRequests();
+
+  /** \brief sends a signed Data in reply to \p interest
+   */
+  void
+  sendReply(const Interest& interest, const Data& data);
+
   virtual void
   sendInterest(const Interest& interest);
 
@@ -89,36 +219,34 @@ private: // send path
   virtual void
   sendElement(const Block& block);
 
+  /** \brief send \p header followed by \p payload as one element
+   *
+   *  The default implementation concatenates them and calls sendElement(block).
+   */
+  virtual void
+  sendElement(const Block& header, const Block& payload);
+
 private: // management
   virtual void
   registerPrefix(const Name& prefix) = 0;
 
 private:
-  struct PendingInterest
-  {
-    Interest interest;
-    OnData onData;
-    OnNack onNack;
-    OnTimeout onTimeout;
-    util::SchedulerEventId timeoutEvent;
-  };
-  typedef std::list<PendingInterest> PendingInterestList;
-
-  struct Listener
-  {
-    Name prefix;
-    OnInterest onInterest;
-  };
-  typedef std::list<Listener> ListenerList;
-
   void
-  onInterestTimeout(PendingInterestList::iterator it);
+  onInterestTimeout(PendingInterestTable::iterator it);
 
 private:
-  PendingInterestList m_pendingInterests;
-  ListenerList m_listeners;
+  PendingInterestTable m_pendingInterests;
+  ListenerTable m_listeners;
+  ReplyCache m_replyCache;
+  RequestCounters m_requestCounters;
+  util::RttEstimator m_rttEstimator;
+  RateController m_rateController;
+  util::MemoryPool m_requestPool;
 };
 
+std::ostream&
+operator<<(std::ostream& os, ClientFace::TraceEventKind evt);
+
 } // namespace ndn
 
 #endif // NDNCXXEXT_CLIENT_FACE_HPP
@@ -0,0 +1,58 @@
+#include "data-template.hpp"
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/security/signature-sha256-with-rsa.hpp>
+
+namespace ndn {
+
+DataTemplate::DataTemplate(const Data& prototype)
+{
+  Data data(prototype);
+  if (!data.getSignature()) {
+    addFakeSignature(data);
+  }
+
+  const Block& wire = data.wireEncode();
+  wire.parse();
+  BOOST_ASSERT(wire.elements_size() > 0 && wire.elements_begin()->type() == tlv::Name);
+
+  // tail starts after Name, and refers to the same buffer
+  m_tail = Block(wire.getBuffer(), wire.elements_begin()->end(), wire.end(), false);
+}
+
+Block
+DataTemplate::encodeHeader(const Name& name) const
+{
+  // reserve exactly the header size, instead of the default MAX_NDN_PACKET_SIZE
+  EncodingEstimator estimator;
+  size_t nameSize = name.wireEncode(estimator);
+  size_t length = m_tail.size() + nameSize;
+  size_t headerSize = tlv::sizeOfVarNumber(tlv::Data) + tlv::sizeOfVarNumber(length) + nameSize;
+
+  EncodingBuffer encoder(headerSize, 0);
+  name.wireEncode(encoder);
+  encoder.prependVarNumber(length);
+  encoder.prependVarNumber(tlv::Data);
+  return encoder.block(false);
+}
+
+Data
+DataTemplate::makeData(const Name& name) const
+{
+  Block header = this->encodeHeader(name);
+  auto buffer = make_shared<Buffer>(header.size() + m_tail.size());
+  std::copy(header.wire(), header.wire() + header.size(), buffer->begin());
+  std::copy(m_tail.wire(), m_tail.wire() + m_tail.size(), buffer->begin() + header.size());
+  return Data(Block(buffer));
+}
+
+void
+DataTemplate::addFakeSignature(Data& data)
+{
+  ndn::SignatureSha256WithRsa fakeSignature;
+  fakeSignature.setValue(ndn::dataBlock(tlv::SignatureValue,
+                                        static_cast<const uint8_t*>(nullptr), 0));
+  data.setSignature(fakeSignature);
+}
+
+} // namespace ndn
@@ -0,0 +1,58 @@
+#ifndef NDNCXXEXT_DATA_TEMPLATE_HPP
+#define NDNCXXEXT_DATA_TEMPLATE_HPP
+
+#include "common.hpp"
+#include <ndn-cxx/data.hpp>
+
+namespace ndn {
+
+/** \brief pre-encoded Data with a replaceable Name
+ *
+ *  MetaInfo, Content, SignatureInfo, and SignatureValue of a prototype Data are encoded once
+ *  into a tail Block. A Data with another Name is made of a header, which contains
+ *  Data TLV-TYPE, TLV-LENGTH, and the Name, followed by the shared tail.
+ *  The tail is not copied per Data.
+ *
+ *  Since the signature is reused, it does not cover the Name. This is suitable only where
+ *  signatures are not verified, such as the fake signature added by ClientFace::reply.
+ */
+class DataTemplate
+{
+public:
+  /** \param prototype Data whose fields other than Name are used;
+   *                   if it has no signature, a fake signature is added
+   */
+  explicit
+  DataTemplate(const Data& prototype);
+
+  /** \return Data TLV-TYPE, TLV-LENGTH, and Name, to be followed by getTail()
+   */
+  Block
+  encodeHeader(const Name& name) const;
+
+  /** \return MetaInfo, Content, SignatureInfo, and SignatureValue elements
+   */
+  const Block&
+  getTail() const
+  {
+    return m_tail;
+  }
+
+  /** \return a Data decoded from header and tail
+   *  \note This copies the payload, and is slower than sending header and tail.
+   */
+  Data
+  makeData(const Name& name) const;
+
+  /** \brief adds a fake SignatureSha256WithRsa with empty SignatureValue
+   */
+  static void
+  addFakeSignature(Data& data);
+
+private:
+  Block m_tail;
+};
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_DATA_TEMPLATE_HPP
@@ -0,0 +1,155 @@
+#ifndef NDNCXXEXT_LISTENER_TABLE_HPP
+#define NDNCXXEXT_LISTENER_TABLE_HPP
+
+#include "common.hpp"
+#include "util/name-hash.hpp"
+#include <unordered_map>
+#include <ndn-cxx/face.hpp>
+
+namespace ndn {
+
+/** \brief table of Interest listeners
+ *
+ *  Listeners are stored in a name component trie.
+ *  Lookup cost depends on the depth of Interest Name, not the number of listeners.
+ *
+ *  Listeners are held by shared_ptr. A listener obtained from lookup remains valid
+ *  after it is replaced or erased, so that its callback may change the table.
+ *
+ *  \tparam Callback type of listener callback
+ */
+template<typename Callback>
+class BasicListenerTable : noncopyable
+{
+public:
+  struct Listener
+  {
+    Name prefix;
+    Callback onInterest;
+  };
+
+public:
+  BasicListenerTable();
+
+  /** \brief inserts or replaces the listener of \p prefix
+   *
+   *  A replaced listener is not modified; a new listener takes its place.
+   *  \return true if inserted, false if replaced
+   */
+  bool
+  insert(const Name& prefix, const Callback& onInterest);
+
+  /** \brief erases the listener of \p prefix
+   *  \return whether a listener is erased
+   */
+  bool
+  erase(const Name& prefix);
+
+  /** \return the listener whose prefix is the longest prefix of \p name,
+   *          or nullptr if no listener matches
+   */
+  shared_ptr<const Listener>
+  findLongestPrefixMatch(const Name& name) const;
+
+  size_t
+  size() const
+  {
+    return m_nListeners;
+  }
+
+private:
+  struct Node
+  {
+    Node* parent;
+    std::unordered_map<name::Component, unique_ptr<Node>, util::ComponentHash> children;
+    shared_ptr<const Listener> listener;
+  };
+
+  Node m_root;
+  size_t m_nListeners;
+};
+
+/** \brief table of Interest listeners registered on a ClientFace
+ */
+typedef BasicListenerTable<OnInterest> ListenerTable;
+
+template<typename Callback>
+BasicListenerTable<Callback>::BasicListenerTable()
+  : m_nListeners(0)
+{
+  m_root.parent = nullptr;
+}
+
+template<typename Callback>
+bool
+BasicListenerTable<Callback>::insert(const Name& prefix, const Callback& onInterest)
+{
+  Node* node = &m_root;
+  for (const name::Component& comp : prefix) {
+    unique_ptr<Node>& child = node->children[comp];
+    if (child == nullptr) {
+      child.reset(new Node);
+      child->parent = node;
+    }
+    node = child.get();
+  }
+
+  bool isNew = node->listener == nullptr;
+  if (isNew) {
+    ++m_nListeners;
+  }
+  node->listener = make_shared<const Listener>(Listener{prefix, onInterest});
+  return isNew;
+}
+
+template<typename Callback>
+bool
+BasicListenerTable<Callback>::erase(const Name& prefix)
+{
+  Node* node = &m_root;
+  for (const name::Component& comp : prefix) {
+    auto it = node->children.find(comp);
+    if (it == node->children.end()) {
+      return false;
+    }
+    node = it->second.get();
+  }
+
+  if (node->listener == nullptr) {
+    return false;
+  }
+  node->listener.reset();
+  --m_nListeners;
+
+  // prune nodes that have neither listener nor children
+  for (ssize_t i = prefix.size() - 1; i >= 0 && node->listener == nullptr &&
+                                      node->children.empty(); --i) {
+    Node* parent = node->parent;
+    parent->children.erase(prefix.get(i));
+    node = parent;
+  }
+  return true;
+}
+
+template<typename Callback>
+shared_ptr<const typename BasicListenerTable<Callback>::Listener>
+BasicListenerTable<Callback>::findLongestPrefixMatch(const Name& name) const
+{
+  const Node* node = &m_root;
+  const Node* match = node;
+  for (const name::Component& comp : name) {
+    auto it = node->children.find(comp);
+    if (it == node->children.end()) {
+      break;
+    }
+    node = it->second.get();
+    if (node->listener != nullptr) {
+      match = node;
+    }
+  }
+  return match->listener;
+}
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_LISTENER_TABLE_HPP
@@ -1,9 +1,46 @@
 #include "nack.hpp"
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
 
 namespace ndn {
 
 const Name Nack::PREFIX("ndn:/localhop/NACK");
 
+static uint64_t
+toLpNackReason(NackCode code)
+{
+  switch (code) {
+  case Nack::BUSY:
+    return Nack::LP_NACK_REASON_CONGESTION;
+  case Nack::DUPLICATE:
+    return Nack::LP_NACK_REASON_DUPLICATE;
+  case Nack::GIVEUP:
+    return Nack::LP_NACK_REASON_NO_ROUTE;
+  case Nack::NODATA:
+    return Nack::LP_NACK_REASON_NODATA;
+  default:
+    return Nack::LP_NACK_REASON_NONE;
+  }
+}
+
+static NackCode
+fromLpNackReason(uint64_t reason)
+{
+  switch (reason) {
+  case Nack::LP_NACK_REASON_CONGESTION:
+    return Nack::BUSY;
+  case Nack::LP_NACK_REASON_DUPLICATE:
+    return Nack::DUPLICATE;
+  case Nack::LP_NACK_REASON_NO_ROUTE:
+    return Nack::GIVEUP;
+  case Nack::LP_NACK_REASON_NODATA:
+    return Nack::NODATA;
+  default:
+    // NDNLPv2: an unknown reason is treated as None
+    return Nack::NONE;
+  }
+}
+
 Interest
 Nack::encode() const
 {
@@ -33,6 +70,65 @@ Nack::decode(const Interest& packet)
   return true;
 }
 
+Block
+Nack::encodeLpHeader() const
+{
+  const Block& interestWire = m_interest.wireEncode();
+
+  // prepend in reverse order; Interest wire is not copied
+  EncodingBuffer encoder;
+  size_t length = interestWire.size();
+  length += encoder.prependVarNumber(interestWire.size());
+  length += encoder.prependVarNumber(TLV_LP_FRAGMENT);
+
+  size_t nackLength = 0;
+  if (m_retryAfter > time::milliseconds::zero()) {
+    nackLength += prependNonNegativeIntegerBlock(encoder, TLV_LP_NACK_RETRY_AFTER,
+                                                 m_retryAfter.count());
+  }
+  uint64_t reason = toLpNackReason(m_code);
+  if (reason != LP_NACK_REASON_NONE) {
+    nackLength += prependNonNegativeIntegerBlock(encoder, TLV_LP_NACK_REASON, reason);
+  }
+  length += nackLength;
+  length += encoder.prependVarNumber(nackLength);
+  length += encoder.prependVarNumber(TLV_LP_NACK);
+
+  encoder.prependVarNumber(length);
+  encoder.prependVarNumber(TLV_LP_PACKET);
+  return encoder.block(false);
+}
+
+bool
+Nack::decodeLp(const Block& lpPacket)
+{
+  if (lpPacket.type() != TLV_LP_PACKET) {
+    return false;
+  }
+
+  try {
+    lpPacket.parse();
+    Block::element_const_iterator nackIt = lpPacket.find(TLV_LP_NACK);
+    Block::element_const_iterator fragmentIt = lpPacket.find(TLV_LP_FRAGMENT);
+    if (nackIt == lpPacket.elements_end() || fragmentIt == lpPacket.elements_end()) {
+      return false;
+    }
+
+    nackIt->parse();
+    Block::element_const_iterator reasonIt = nackIt->find(TLV_LP_NACK_REASON);
+    m_code = reasonIt == nackIt->elements_end() ?
+             NONE : fromLpNackReason(readNonNegativeInteger(*reasonIt));
+    Block::element_const_iterator retryAfterIt = nackIt->find(TLV_LP_NACK_RETRY_AFTER);
+    m_retryAfter = retryAfterIt == nackIt->elements_end() ? time::milliseconds::zero() :
+                   time::milliseconds(readNonNegativeInteger(*retryAfterIt));
+    m_interest.wireDecode(fragmentIt->blockFromValue());
+  }
+  catch (tlv::Error&) {
+    return false;
+  }
+  return true;
+}
+
 std::ostream&
 operator<<(std::ostream& os, NackCode code)
 {
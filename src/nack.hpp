@@ -21,12 +21,14 @@ public:
 
   Nack()
     : m_code(NONE)
+    , m_retryAfter(time::milliseconds::zero())
   {
   }
 
   Nack(NackCode code, const Interest& interest)
     : m_code(code)
     , m_interest(interest)
+    , m_retryAfter(time::milliseconds::zero())
   {
   }
 
@@ -42,6 +44,25 @@ public:
     return m_interest;
   }
 
+  /** \return how long the consumer should wait before retrying, as suggested by producer;
+   *          zero if there's no suggestion
+   */
+  time::milliseconds
+  getRetryAfter() const
+  {
+    return m_retryAfter;
+  }
+
+  /** \brief sets retry-after hint
+   *
+   *  The hint is carried in LpPacket encoding only.
+   */
+  void
+  setRetryAfter(const time::milliseconds& retryAfter)
+  {
+    m_retryAfter = retryAfter;
+  }
+
 public:
   /** \brief encode NACK to an Interest (hack)
    *
@@ -58,7 +79,54 @@ public:
   bool
   decode(const Interest& packet);
 
+  /** \brief encode NACK as an NDNLPv2-style LpPacket header
+   *
+   *  LpPacket := LP-PACKET-TYPE TLV-LENGTH
+   *                Nack := NACK-TYPE TLV-LENGTH NackReason? NackRetryAfter?
+   *                Fragment := FRAGMENT-TYPE TLV-LENGTH <interest wire>
+   *
+   *  The returned header is followed by getInterest().wireEncode() on the wire;
+   *  they can be sent with Transport::send(header, payload) without concatenation.
+   *  NackReason carries NackCode mapped to NDNLPv2 reason: BUSY is Congestion,
+   *  DUPLICATE is Duplicate, GIVEUP is NoRoute; NODATA has no NDNLPv2 counterpart and uses
+   *  LP_NACK_REASON_NODATA, which a standard forwarder treats as an unknown reason.
+   *  NackRetryAfter carries retry-after hint in milliseconds;
+   *  it is not assigned by NDNLPv2, and is omitted if the hint is zero.
+   */
+  Block
+  encodeLpHeader() const;
+
+  /** \brief decode NACK from an LpPacket
+   *
+   *  The decoded Interest shares the buffer of \p lpPacket.
+   *  An unknown NackReason is decoded as NONE, as NDNLPv2 requires.
+   *  \retval true success
+   *  \retval false \p lpPacket is not an LpPacket with Nack field, or is malformed
+   */
+  bool
+  decodeLp(const Block& lpPacket);
+
 public:
+  /** \brief TLV-TYPE numbers used in LpPacket encoding, as assigned by NDNLPv2
+   */
+  enum {
+    TLV_LP_PACKET = 100,
+    TLV_LP_FRAGMENT = 80,
+    TLV_LP_NACK = 800,
+    TLV_LP_NACK_REASON = 801,
+    TLV_LP_NACK_RETRY_AFTER = 802 ///< extension, not assigned by NDNLPv2
+  };
+
+  /** \brief NackReason values in LpPacket encoding
+   */
+  enum {
+    LP_NACK_REASON_NONE = 0,
+    LP_NACK_REASON_CONGESTION = 50,
+    LP_NACK_REASON_DUPLICATE = 100,
+    LP_NACK_REASON_NO_ROUTE = 150,
+    LP_NACK_REASON_NODATA = 162 ///< extension, not assigned by NDNLPv2
+  };
+
   /** \brief ndn:/localhop/NACK
    */
   static const Name PREFIX;
@@ -66,6 +134,7 @@ public:
 private:
   NackCode m_code;
   Interest m_interest;
+  time::milliseconds m_retryAfter;
 };
 
 typedef Nack::NackCode NackCode;
@@ -0,0 +1,228 @@
+#include "pending-interest-table.hpp"
+#include "util/name-hash.hpp"
+
+namespace ndn {
+
+static const size_t INITIAL_N_BUCKETS = 64;
+
+PendingInterestTable::PendingInterestTable()
+  : m_nAllocatedEntries(0)
+  , m_buckets(INITIAL_N_BUCKETS, nullptr)
+{
+}
+
+bool
+PendingInterestTable::needsFallback(const Interest& interest)
+{
+  // an implicit digest component is not part of Data Name,
+  // so the Interest cannot be found among the prefixes of Data Name
+  const Name& name = interest.getName();
+  return !name.empty() && name.at(-1).value_size() == 32;
+}
+
+PendingInterestTable::iterator
+PendingInterestTable::insert(const Interest& interest)
+{
+  if (m_spare.empty()) {
+    m_spare.emplace_back();
+    m_spare.back().self = std::prev(m_spare.end());
+    ++m_nAllocatedEntries;
+  }
+
+  iterator it = m_spare.begin();
+  it->interest = interest;
+  it->nameHash = util::hashName(interest.getName());
+  if (needsFallback(interest)) {
+    m_fallback.splice(m_fallback.end(), m_spare, it);
+    it->isIndexed = false;
+  }
+  else {
+    m_indexed.splice(m_indexed.end(), m_spare, it);
+    it->isIndexed = true;
+    this->index(it);
+  }
+  return it;
+}
+
+void
+PendingInterestTable::index(iterator it)
+{
+  if (m_indexed.size() > m_buckets.size()) {
+    // rehash links every indexed entry, including this one
+    this->rehash(m_buckets.size() * 2);
+    return;
+  }
+
+  Entry*& head = m_buckets[it->nameHash & (m_buckets.size() - 1)];
+  it->hashPrev = nullptr;
+  it->hashNext = head;
+  if (head != nullptr) {
+    head->hashPrev = &*it;
+  }
+  head = &*it;
+}
+
+void
+PendingInterestTable::unindex(iterator it)
+{
+  BOOST_ASSERT(it->isIndexed);
+  if (it->hashPrev != nullptr) {
+    it->hashPrev->hashNext = it->hashNext;
+  }
+  else {
+    m_buckets[it->nameHash & (m_buckets.size() - 1)] = it->hashNext;
+  }
+  if (it->hashNext != nullptr) {
+    it->hashNext->hashPrev = it->hashPrev;
+  }
+}
+
+void
+PendingInterestTable::rehash(size_t nBuckets)
+{
+  // a bucket array, once grown, is kept; this allocates only when table reaches a new size
+  m_buckets.assign(nBuckets, nullptr);
+  for (Entry& entry : m_indexed) {
+    Entry*& head = m_buckets[entry.nameHash & (nBuckets - 1)];
+    entry.hashPrev = nullptr;
+    entry.hashNext = head;
+    if (head != nullptr) {
+      head->hashPrev = &entry;
+    }
+    head = &entry;
+  }
+}
+
+void
+PendingInterestTable::erase(iterator it)
+{
+  clearEntry(*it);
+  if (it->isIndexed) {
+    this->unindex(it);
+    m_spare.splice(m_spare.end(), m_indexed, it);
+  }
+  else {
+    m_spare.splice(m_spare.end(), m_fallback, it);
+  }
+}
+
+void
+PendingInterestTable::extract(iterator it, EntryList& extracted)
+{
+  if (it->isIndexed) {
+    this->unindex(it);
+    extracted.splice(extracted.end(), m_indexed, it);
+  }
+  else {
+    extracted.splice(extracted.end(), m_fallback, it);
+  }
+}
+
+void
+PendingInterestTable::recycle(EntryList& entries)
+{
+  for (Entry& entry : entries) {
+    clearEntry(entry);
+  }
+  m_spare.splice(m_spare.end(), entries);
+}
+
+void
+PendingInterestTable::clearEntry(Entry& entry)
+{
+  // Interest is kept, so that its capacity can be reused
+  entry.onData = nullptr;
+  entry.onNack = nullptr;
+  entry.onTimeout = nullptr;
+  entry.timeoutEvent.reset();
+  entry.followers.clear();
+}
+
+template<typename Pred>
+void
+PendingInterestTable::extractIndexed(size_t nameHash, const Pred& pred, EntryList& satisfied)
+{
+  Entry* entry = m_buckets[nameHash & (m_buckets.size() - 1)];
+  while (entry != nullptr) {
+    Entry* next = entry->hashNext;
+    if (entry->nameHash == nameHash && pred(*entry)) {
+      this->unindex(entry->self);
+      satisfied.splice(satisfied.end(), m_indexed, entry->self);
+    }
+    entry = next;
+  }
+}
+
+void
+PendingInterestTable::extractDataMatches(const Data& data, EntryList& satisfied)
+{
+  auto isMatch = [&data] (const Entry& entry) {
+    return entry.interest.matchesData(data);
+  };
+
+  const Name& name = data.getName();
+  size_t prefixHash = util::EMPTY_NAME_HASH;
+  for (size_t prefixLen = 0; prefixLen <= name.size() && !m_indexed.empty(); ++prefixLen) {
+    if (prefixLen > 0) {
+      prefixHash = util::extendNameHash(prefixHash, name.get(prefixLen - 1));
+    }
+    this->extractIndexed(prefixHash, isMatch, satisfied);
+  }
+
+  for (iterator it = m_fallback.begin(); it != m_fallback.end();) {
+    iterator next = std::next(it);
+    if (isMatch(*it)) {
+      satisfied.splice(satisfied.end(), m_fallback, it);
+    }
+    it = next;
+  }
+}
+
+bool
+PendingInterestTable::isSameInterest(const Entry& entry, const Interest& interest)
+{
+  return entry.interest.getName() == interest.getName() &&
+         entry.interest.getSelectors() == interest.getSelectors();
+}
+
+void
+PendingInterestTable::extractNackMatches(const Interest& interest, EntryList& satisfied)
+{
+  auto isMatch = [&interest] (const Entry& entry) {
+    return isSameInterest(entry, interest);
+  };
+
+  this->extractIndexed(util::hashName(interest.getName()), isMatch, satisfied);
+
+  for (iterator it = m_fallback.begin(); it != m_fallback.end();) {
+    iterator next = std::next(it);
+    if (isMatch(*it)) {
+      satisfied.splice(satisfied.end(), m_fallback, it);
+    }
+    it = next;
+  }
+}
+
+PendingInterestTable::Entry*
+PendingInterestTable::findSameInterest(const Interest& interest)
+{
+  if (needsFallback(interest)) {
+    for (Entry& entry : m_fallback) {
+      if (isSameInterest(entry, interest)) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  size_t nameHash = util::hashName(interest.getName());
+  for (Entry* entry = m_buckets[nameHash & (m_buckets.size() - 1)];
+       entry != nullptr; entry = entry->hashNext) {
+    if (entry->nameHash == nameHash && isSameInterest(*entry, interest)) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace ndn
@@ -0,0 +1,168 @@
+#ifndef NDNCXXEXT_PENDING_INTEREST_TABLE_HPP
+#define NDNCXXEXT_PENDING_INTEREST_TABLE_HPP
+
+#include "nack.hpp"
+#include "util/scheduler.hpp"
+#include <list>
+#include <ndn-cxx/face.hpp>
+
+namespace ndn {
+
+typedef function<void(const Interest&, const Nack&)> OnNack;
+
+/** \brief table of outstanding Interests expressed by a ClientFace
+ *
+ *  Entries are indexed by the hash of Interest Name, in an intrusive hash table.
+ *  An incoming Data is matched by looking up the hash of each prefix of Data Name,
+ *  so that the cost depends on Name depth rather than the number of entries.
+ *  Interests whose Name may end with an implicit digest cannot be found this way;
+ *  they are kept in a fallback list that is scanned linearly.
+ *
+ *  Erased and recycled entries are kept as spare list nodes, and reused by later inserts.
+ *  Because an entry keeps its Interest object, assigning a new Interest into it can reuse
+ *  the capacity of its containers as well.
+ */
+class PendingInterestTable : noncopyable
+{
+public:
+  PendingInterestTable();
+
+  /** \brief a request aggregated onto an entry, see ClientFace::shouldAggregateInterests
+   */
+  struct Follower
+  {
+    Interest interest;
+    OnData onData;
+    OnNack onNack;
+    OnTimeout onTimeout;
+  };
+
+  struct Entry
+  {
+    Interest interest;
+    OnData onData;
+    OnNack onNack;
+    OnTimeout onTimeout;
+    util::SchedulerEventId timeoutEvent;
+    std::vector<Follower> followers;
+    time::steady_clock::TimePoint sendTime;
+    bool isRetransmission; ///< if true, RTT is not measured (Karn's rule)
+    bool isRateControlled; ///< if true, entry is counted in a RateController flow
+
+  private:
+    size_t nameHash;
+    bool isIndexed;
+    Entry* hashPrev;
+    Entry* hashNext;
+    std::list<Entry>::iterator self;
+
+    friend class PendingInterestTable;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  /** \brief refers to an entry; remains valid until the entry is erased or extracted
+   */
+  typedef EntryList::iterator iterator;
+
+public:
+  /** \brief inserts an entry for \p interest
+   *  \return the new entry, whose callbacks and timeout event are to be filled by caller
+   */
+  iterator
+  insert(const Interest& interest);
+
+  /** \brief erases an entry in O(1)
+   */
+  void
+  erase(iterator it);
+
+  /** \brief moves an entry onto the end of \p extracted in O(1)
+   */
+  void
+  extract(iterator it, EntryList& extracted);
+
+  /** \brief recycles entries previously extracted from this table
+   *  \post \p entries is empty
+   */
+  void
+  recycle(EntryList& entries);
+
+  /** \brief moves entries satisfied by \p data onto the end of \p satisfied
+   */
+  void
+  extractDataMatches(const Data& data, EntryList& satisfied);
+
+  /** \brief moves entries with same Name and Selectors as \p interest
+   *         onto the end of \p satisfied
+   */
+  void
+  extractNackMatches(const Interest& interest, EntryList& satisfied);
+
+  /** \return an entry with same Name and Selectors as \p interest, or nullptr
+   */
+  Entry*
+  findSameInterest(const Interest& interest);
+
+  size_t
+  size() const
+  {
+    return m_indexed.size() + m_fallback.size();
+  }
+
+  bool
+  empty() const
+  {
+    return this->size() == 0;
+  }
+
+  /** \return number of entries obtained from the system
+   */
+  size_t
+  getNAllocatedEntries() const
+  {
+    return m_nAllocatedEntries;
+  }
+
+private:
+  /** \return whether \p interest cannot be matched by Data Name prefix lookup
+   */
+  static bool
+  needsFallback(const Interest& interest);
+
+  /** \return whether \p entry has same Name and Selectors as \p interest
+   */
+  static bool
+  isSameInterest(const Entry& entry, const Interest& interest);
+
+  void
+  index(iterator it);
+
+  void
+  unindex(iterator it);
+
+  void
+  rehash(size_t nBuckets);
+
+  /** \brief moves indexed entries with \p nameHash that satisfy \p pred onto \p satisfied
+   */
+  template<typename Pred>
+  void
+  extractIndexed(size_t nameHash, const Pred& pred, EntryList& satisfied);
+
+  /** \brief releases references held by an entry
+   */
+  static void
+  clearEntry(Entry& entry);
+
+private:
+  EntryList m_indexed;
+  EntryList m_fallback;
+  EntryList m_spare;
+  size_t m_nAllocatedEntries;
+  std::vector<Entry*> m_buckets;
+};
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_PENDING_INTEREST_TABLE_HPP
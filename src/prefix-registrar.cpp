@@ -0,0 +1,250 @@
+#include "prefix-registrar.hpp"
+#include "util/logger.hpp"
+#include <ndn-cxx/management/nfd-control-command.hpp>
+#include <ndn-cxx/management/nfd-control-response.hpp>
+#include <algorithm>
+#include <sstream>
+
+namespace ndn {
+
+PrefixRegistrar::PrefixRegistrar(ClientFace& face, boost::asio::io_service& io)
+  : maxOutstanding(16)
+  , commandTimeout(time::seconds(4))
+  , shouldLogFailure(true)
+  , m_face(face)
+  , m_io(io)
+  , m_nOutstanding(0)
+  , m_nPending(0)
+  , m_counters()
+  , m_isAlive(make_shared<bool>(true))
+{
+}
+
+PrefixRegistrar::~PrefixRegistrar()
+{
+  *m_isAlive = false;
+  m_signWork.reset();
+  m_signIo.stop();
+  if (m_signThread.joinable()) {
+    m_signThread.join();
+  }
+}
+
+PrefixRegistrar::EntryMap::iterator
+PrefixRegistrar::findCovering(const Name& prefix)
+{
+  for (size_t len = 0; len <= prefix.size(); ++len) {
+    EntryMap::iterator it = m_entries.find(prefix.getPrefix(len));
+    if (it != m_entries.end()) {
+      return it;
+    }
+  }
+  return m_entries.end();
+}
+
+void
+PrefixRegistrar::registerPrefix(const Name& prefix, const OnResult& onResult)
+{
+  ++m_counters.nRequested;
+  Waiter waiter{prefix, onResult, time::steady_clock::now(), false};
+
+  EntryMap::iterator it = this->findCovering(prefix);
+  if (it == m_entries.end()) {
+    Entry& entry = m_entries[prefix];
+    entry.state = ENTRY_PENDING;
+    entry.waiters.push_back(std::move(waiter));
+    ++m_nPending;
+    m_queue.push_back(prefix);
+    this->dispatch();
+    return;
+  }
+
+  ++m_counters.nCovered;
+  waiter.isCovered = true;
+  if (it->second.state == ENTRY_PENDING) {
+    it->second.waiters.push_back(std::move(waiter));
+    ++m_nPending;
+    return;
+  }
+
+  ++m_counters.nSucceeded;
+  if (onResult != nullptr) {
+    onResult(Result{prefix, true, it->first, time::nanoseconds::zero(), ""});
+  }
+}
+
+void
+PrefixRegistrar::registerPrefixes(const std::vector<Name>& prefixes,
+                                  const OnBatchResult& onResult)
+{
+  std::vector<size_t> order(prefixes.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&prefixes] (size_t a, size_t b) {
+    return prefixes[a].size() < prefixes[b].size();
+  });
+
+  if (onResult == nullptr) {
+    for (size_t i : order) {
+      this->registerPrefix(prefixes[i]);
+    }
+    return;
+  }
+
+  struct Batch
+  {
+    std::vector<Result> results;
+    size_t nRemaining;
+  };
+  auto batch = make_shared<Batch>();
+  batch->results.resize(prefixes.size());
+  batch->nRemaining = prefixes.size();
+  if (prefixes.empty()) {
+    onResult(batch->results);
+    return;
+  }
+
+  for (size_t i : order) {
+    this->registerPrefix(prefixes[i], [batch, i, onResult] (const Result& result) {
+      batch->results[i] = result;
+      if (--batch->nRemaining == 0) {
+        onResult(batch->results);
+      }
+    });
+  }
+}
+
+void
+PrefixRegistrar::dispatch()
+{
+  while (m_nOutstanding < maxOutstanding && !m_queue.empty()) {
+    Name prefix = m_queue.front();
+    m_queue.pop_front();
+    ++m_nOutstanding;
+    m_entries.at(prefix).dispatchTime = time::steady_clock::now();
+
+    if (!m_signThread.joinable()) {
+      m_signWork.reset(new boost::asio::io_service::work(m_signIo));
+      m_signThread = std::thread([this] { m_signIo.run(); });
+    }
+    m_signIo.post(bind(&PrefixRegistrar::signCommand, this, prefix));
+  }
+}
+
+void
+PrefixRegistrar::signCommand(const Name& prefix)
+{
+  static const Name COMMAND_PREFIX("/localhost/nfd");
+
+  shared_ptr<bool> isAlive = m_isAlive;
+  try {
+    if (m_keyChain == nullptr) {
+      m_keyChain.reset(new KeyChain);
+    }
+
+    nfd::ControlParameters parameters;
+    parameters.setName(prefix);
+    nfd::RibRegisterCommand command;
+    Interest requestInterest(command.getRequestName(COMMAND_PREFIX, parameters));
+    m_keyChain->sign(requestInterest);
+
+    m_io.post([this, isAlive, requestInterest, prefix] {
+      if (*isAlive) {
+        this->sendCommand(requestInterest, prefix);
+      }
+    });
+  }
+  catch (const std::exception& e) {
+    std::string reason = std::string("signing error: ") + e.what();
+    m_io.post([this, isAlive, prefix, reason] {
+      if (*isAlive) {
+        this->finish(prefix, false, reason);
+      }
+    });
+  }
+}
+
+void
+PrefixRegistrar::sendCommand(const Interest& command, const Name& prefix)
+{
+  ++m_counters.nCommands;
+  m_face.request(command,
+                 bind(&PrefixRegistrar::handleResponse, this, prefix, _2),
+                 [this, prefix] (const Interest&, const Nack& nack) {
+                   std::ostringstream reason;
+                   reason << "Nack " << nack.getCode();
+                   this->finish(prefix, false, reason.str());
+                 },
+                 bind(&PrefixRegistrar::finish, this, prefix, false, "timeout"),
+                 commandTimeout);
+}
+
+void
+PrefixRegistrar::handleResponse(const Name& prefix, const Data& data)
+{
+  nfd::ControlResponse response;
+  try {
+    response.wireDecode(data.getContent().blockFromValue());
+  }
+  catch (const tlv::Error& e) {
+    this->finish(prefix, false, std::string("malformed response: ") + e.what());
+    return;
+  }
+
+  if (response.getCode() != 200) {
+    std::ostringstream reason;
+    reason << response.getCode();
+    if (!response.getText().empty()) {
+      reason << " " << response.getText();
+    }
+    this->finish(prefix, false, reason.str());
+    return;
+  }
+  this->finish(prefix, true, "");
+}
+
+void
+PrefixRegistrar::finish(const Name& prefix, bool isSuccess, const std::string& reason)
+{
+  --m_nOutstanding;
+  EntryMap::iterator it = m_entries.find(prefix);
+  BOOST_ASSERT(it != m_entries.end());
+
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  time::nanoseconds commandLatency = now - it->second.dispatchTime;
+  m_counters.maxLatency = std::max(m_counters.maxLatency, commandLatency);
+  m_counters.totalLatency += commandLatency;
+
+  std::vector<Waiter> waiters;
+  waiters.swap(it->second.waiters);
+  if (isSuccess) {
+    it->second.state = ENTRY_REGISTERED;
+  }
+  else {
+    // a failed prefix may be requested again
+    m_entries.erase(it);
+    if (shouldLogFailure) {
+      LOG("RibRegister " << reason << " " << prefix);
+    }
+  }
+
+  this->dispatch();
+
+  for (const Waiter& waiter : waiters) {
+    --m_nPending;
+    if (isSuccess) {
+      ++m_counters.nSucceeded;
+    }
+    else {
+      ++m_counters.nFailed;
+    }
+    if (waiter.onResult != nullptr) {
+      waiter.onResult(Result{waiter.prefix, isSuccess,
+                             waiter.isCovered ? prefix : Name(),
+                             now - waiter.requestTime, reason});
+    }
+  }
+}
+
+} // namespace ndn
@@ -0,0 +1,169 @@
+#ifndef NDNCXXEXT_PREFIX_REGISTRAR_HPP
+#define NDNCXXEXT_PREFIX_REGISTRAR_HPP
+
+#include "client-face.hpp"
+#include <deque>
+#include <map>
+#include <thread>
+
+namespace ndn {
+
+/** \brief registers prefixes with the local forwarder through a ClientFace
+ *
+ *  Prefix registration commands are signed on a worker thread with its own KeyChain,
+ *  so that RSA signing does not stall the io thread. Signed commands are sent on the
+ *  io thread; at most maxOutstanding commands are being signed or awaiting response,
+ *  and further prefixes are queued.
+ *
+ *  A prefix that is registered, or being registered, is not registered again;
+ *  neither is a prefix covered by such a prefix. Its result is the result of the covering prefix.
+ *
+ *  All public methods and callbacks are on the io thread.
+ */
+class PrefixRegistrar : noncopyable
+{
+public:
+  struct Result
+  {
+    Name prefix;
+    bool isSuccess;
+    /** \brief if not empty, prefix is covered by this prefix, and no command was sent for it
+     */
+    Name coveredBy;
+    /** \brief duration from request to result
+     */
+    time::nanoseconds latency;
+    /** \brief if not success, why registration failed
+     */
+    std::string reason;
+  };
+
+  typedef function<void(const Result& result)> OnResult;
+  typedef function<void(const std::vector<Result>& results)> OnBatchResult;
+
+  struct Counters
+  {
+    uint64_t nRequested; ///< prefixes requested
+    uint64_t nCommands; ///< commands sent
+    uint64_t nCovered; ///< prefixes not sent because they are covered
+    uint64_t nSucceeded; ///< prefixes registered, including covered prefixes
+    uint64_t nFailed; ///< prefixes failed, including covered prefixes
+    time::nanoseconds maxLatency; ///< maximum command latency
+    time::nanoseconds totalLatency; ///< total command latency
+  };
+
+  PrefixRegistrar(ClientFace& face, boost::asio::io_service& io);
+
+  /** \brief stops the signing thread
+   *
+   *  Results of outstanding commands are not reported.
+   */
+  ~PrefixRegistrar();
+
+  /** \brief registers \p prefix
+   *  \param onResult if not nullptr, invoked with the result
+   */
+  void
+  registerPrefix(const Name& prefix, const OnResult& onResult = nullptr);
+
+  /** \brief registers \p prefixes
+   *
+   *  Shorter prefixes are sent first, so that prefixes they cover are deduplicated.
+   *  \param onResult if not nullptr, invoked with the results in the same order as \p prefixes,
+   *                  after every prefix has a result
+   */
+  void
+  registerPrefixes(const std::vector<Name>& prefixes, const OnBatchResult& onResult = nullptr);
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  /** \return number of prefixes that are queued, being signed, or awaiting response
+   */
+  size_t
+  getNPending() const
+  {
+    return m_nPending;
+  }
+
+  /** \brief maximum number of commands being signed or awaiting response
+   */
+  size_t maxOutstanding;
+
+  /** \brief command timeout
+   */
+  time::milliseconds commandTimeout;
+
+  /** \brief whether to log failures
+   */
+  bool shouldLogFailure;
+
+private:
+  struct Waiter
+  {
+    Name prefix;
+    OnResult onResult;
+    time::steady_clock::TimePoint requestTime;
+    bool isCovered;
+  };
+
+  enum EntryState {
+    ENTRY_PENDING,
+    ENTRY_REGISTERED
+  };
+
+  struct Entry
+  {
+    EntryState state;
+    time::steady_clock::TimePoint dispatchTime;
+    std::vector<Waiter> waiters;
+  };
+
+  typedef std::map<Name, Entry> EntryMap;
+
+  /** \return entry of \p prefix or a prefix of it, or m_entries.end()
+   */
+  EntryMap::iterator
+  findCovering(const Name& prefix);
+
+  /** \brief sends queued prefixes within the limit of outstanding commands
+   */
+  void
+  dispatch();
+
+  /** \brief builds and signs the command of \p prefix; invoked on signing thread
+   */
+  void
+  signCommand(const Name& prefix);
+
+  void
+  sendCommand(const Interest& command, const Name& prefix);
+
+  void
+  handleResponse(const Name& prefix, const Data& data);
+
+  void
+  finish(const Name& prefix, bool isSuccess, const std::string& reason);
+
+private:
+  ClientFace& m_face;
+  boost::asio::io_service& m_io;
+  EntryMap m_entries;
+  std::deque<Name> m_queue;
+  size_t m_nOutstanding;
+  size_t m_nPending;
+  Counters m_counters;
+  shared_ptr<bool> m_isAlive;
+
+  boost::asio::io_service m_signIo;
+  unique_ptr<boost::asio::io_service::work> m_signWork;
+  std::thread m_signThread;
+  unique_ptr<KeyChain> m_keyChain; ///< accessed on signing thread only
+};
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_PREFIX_REGISTRAR_HPP
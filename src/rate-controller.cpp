@@ -0,0 +1,117 @@
+#include "rate-controller.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ndn {
+
+RateController::RateController()
+  : initialWindow(2.0)
+  , minWindow(1.0)
+  , maxWindow(1024.0)
+  , decreaseFactor(0.5)
+{
+}
+
+RateController::Flow&
+RateController::enable(const Name& prefix)
+{
+  for (Flow& flow : m_flows) {
+    if (flow.prefix == prefix) {
+      return flow;
+    }
+  }
+
+  m_flows.push_back(Flow());
+  Flow& flow = m_flows.back();
+  flow.prefix = prefix;
+  flow.cwnd = initialWindow;
+  flow.ssthresh = maxWindow;
+  flow.nOutstanding = 0;
+  flow.lastDecrease = time::steady_clock::TimePoint::min();
+  flow.nQueued = 0;
+  flow.nCongestionSignals = 0;
+  flow.nDecreases = 0;
+  return flow;
+}
+
+RateController::Flow*
+RateController::findFlow(const Name& name)
+{
+  Flow* found = nullptr;
+  for (Flow& flow : m_flows) {
+    if (flow.prefix.isPrefixOf(name) &&
+        (found == nullptr || flow.prefix.size() > found->prefix.size())) {
+      found = &flow;
+    }
+  }
+  return found;
+}
+
+bool
+RateController::canSend(const Flow& flow) const
+{
+  return flow.nOutstanding < std::max(static_cast<size_t>(std::floor(flow.cwnd)),
+                                      static_cast<size_t>(1));
+}
+
+void
+RateController::onSend(Flow& flow)
+{
+  ++flow.nOutstanding;
+}
+
+void
+RateController::onData(Flow& flow)
+{
+  this->complete(flow);
+
+  if (flow.cwnd < flow.ssthresh) {
+    flow.cwnd += 1.0;
+  }
+  else {
+    flow.cwnd += 1.0 / flow.cwnd;
+  }
+  flow.cwnd = std::min(flow.cwnd, maxWindow);
+}
+
+void
+RateController::onNack(Flow& flow, const Nack& nack, const time::steady_clock::TimePoint& sendTime)
+{
+  this->complete(flow);
+
+  if (nack.getCode() == Nack::BUSY) {
+    this->decrease(flow, sendTime);
+  }
+}
+
+void
+RateController::onTimeout(Flow& flow, const time::steady_clock::TimePoint& sendTime)
+{
+  this->complete(flow);
+  this->decrease(flow, sendTime);
+}
+
+void
+RateController::complete(Flow& flow)
+{
+  if (flow.nOutstanding > 0) {
+    --flow.nOutstanding;
+  }
+}
+
+void
+RateController::decrease(Flow& flow, const time::steady_clock::TimePoint& sendTime)
+{
+  ++flow.nCongestionSignals;
+  if (sendTime < flow.lastDecrease) {
+    // window has been decreased for congestion seen by an earlier request
+    return;
+  }
+
+  flow.cwnd = std::max(flow.cwnd * decreaseFactor, minWindow);
+  flow.ssthresh = flow.cwnd;
+  flow.lastDecrease = time::steady_clock::now();
+  ++flow.nDecreases;
+}
+
+} // namespace ndn
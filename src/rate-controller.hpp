@@ -0,0 +1,140 @@
+#ifndef NDNCXXEXT_RATE_CONTROLLER_HPP
+#define NDNCXXEXT_RATE_CONTROLLER_HPP
+
+#include "pending-interest-table.hpp"
+#include <deque>
+
+namespace ndn {
+
+/** \brief per-prefix congestion control of requests expressed by a ClientFace
+ *
+ *  Each enabled prefix has a flow with a congestion window, which limits the number of
+ *  outstanding requests under that prefix. A request that exceeds the window is queued,
+ *  and sent when an outstanding request of the same flow completes.
+ *
+ *  The window is adjusted with AIMD. Each Data grows the window by one below ssthresh
+ *  (slow start), or by 1/cwnd otherwise. A NACK with code BUSY or a timeout is a congestion
+ *  signal, which multiplies the window by decreaseFactor. To react once per window of
+ *  requests, a signal for a request sent before the previous decrease is ignored.
+ *
+ *  A request matches the flow with longest prefix of its Name. Flows are scanned linearly,
+ *  because a consumer is expected to enable a few prefixes.
+ */
+class RateController : noncopyable
+{
+public:
+  struct QueuedRequest
+  {
+    Interest interest;
+    OnData onData;
+    OnNack onNack;
+    OnTimeout onTimeout;
+    time::milliseconds timeoutOverride;
+    bool isRetransmission;
+  };
+
+  struct Flow
+  {
+    Name prefix;
+    double cwnd;
+    double ssthresh;
+    size_t nOutstanding;
+    time::steady_clock::TimePoint lastDecrease;
+    std::deque<QueuedRequest> queue;
+
+    uint64_t nQueued; ///< requests that waited in queue
+    uint64_t nCongestionSignals; ///< BUSY NACKs and timeouts
+    uint64_t nDecreases; ///< window decreases
+  };
+
+  typedef std::list<Flow>::iterator iterator;
+
+public:
+  RateController();
+
+  /** \brief enables congestion control of requests under \p prefix
+   *
+   *  The window starts at initialWindow. Enabling a prefix again has no effect.
+   */
+  Flow&
+  enable(const Name& prefix);
+
+  bool
+  isEnabled() const
+  {
+    return !m_flows.empty();
+  }
+
+  /** \return the flow whose prefix is the longest prefix of \p name, or nullptr
+   */
+  Flow*
+  findFlow(const Name& name);
+
+  iterator
+  begin()
+  {
+    return m_flows.begin();
+  }
+
+  iterator
+  end()
+  {
+    return m_flows.end();
+  }
+
+  /** \return whether a request of \p flow can be sent without exceeding the window
+   */
+  bool
+  canSend(const Flow& flow) const;
+
+  /** \brief records that a request of \p flow is sent
+   */
+  void
+  onSend(Flow& flow);
+
+  /** \brief records that a request of \p flow is satisfied by Data
+   */
+  void
+  onData(Flow& flow);
+
+  /** \brief records that a request of \p flow sent at \p sendTime is NACKed
+   */
+  void
+  onNack(Flow& flow, const Nack& nack, const time::steady_clock::TimePoint& sendTime);
+
+  /** \brief records that a request of \p flow sent at \p sendTime times out
+   */
+  void
+  onTimeout(Flow& flow, const time::steady_clock::TimePoint& sendTime);
+
+private:
+  void
+  complete(Flow& flow);
+
+  void
+  decrease(Flow& flow, const time::steady_clock::TimePoint& sendTime);
+
+public:
+  /** \brief window of a newly enabled flow
+   */
+  double initialWindow;
+
+  /** \brief lower bound of window
+   */
+  double minWindow;
+
+  /** \brief upper bound of window
+   */
+  double maxWindow;
+
+  /** \brief window is multiplied by this factor upon congestion signal
+   */
+  double decreaseFactor;
+
+private:
+  std::list<Flow> m_flows;
+};
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_RATE_CONTROLLER_HPP
@@ -0,0 +1,117 @@
+#include "reply-cache.hpp"
+
+namespace ndn {
+
+const size_t ReplyCache::MAX_CANDIDATES;
+
+ReplyCache::ReplyCache()
+  : m_capacity(0)
+  , m_nBytes(0)
+  , m_counters()
+{
+}
+
+void
+ReplyCache::setCapacity(size_t capacity)
+{
+  m_capacity = capacity;
+  this->evict(0);
+}
+
+void
+ReplyCache::insert(const Data& data)
+{
+  size_t wireSize = data.wireEncode().size();
+  if (wireSize > m_capacity) {
+    return;
+  }
+
+  Index::iterator it = m_index.find(data.getName());
+  if (it != m_index.end()) {
+    this->erase(it);
+  }
+  this->evict(wireSize);
+
+  time::steady_clock::TimePoint staleTime = time::steady_clock::now();
+  if (data.getFreshnessPeriod() > time::milliseconds::zero()) {
+    staleTime += data.getFreshnessPeriod();
+  }
+
+  m_lru.push_front(Entry{data, staleTime, wireSize});
+  m_index.emplace(data.getName(), m_lru.begin());
+  m_nBytes += wireSize;
+  ++m_counters.nInserts;
+}
+
+const Data*
+ReplyCache::find(const Interest& interest)
+{
+  const Name& name = interest.getName();
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  auto isMatch = [&] (const Entry& entry) {
+    return (!interest.getMustBeFresh() || entry.staleTime > now) &&
+           interest.matchesData(entry.data);
+  };
+
+  EntryList::iterator match = m_lru.end();
+  Index::iterator first = m_index.lower_bound(name);
+  if (interest.getChildSelector() != 1) {
+    // leftmost: start from the exact Name, which is the first candidate in canonical order
+    size_t nCandidates = 0;
+    for (Index::iterator it = first; it != m_index.end() && nCandidates < MAX_CANDIDATES &&
+                                     name.isPrefixOf(it->first); ++it, ++nCandidates) {
+      if (isMatch(*it->second)) {
+        match = it->second;
+        break;
+      }
+    }
+  }
+  else {
+    // rightmost: walk backward from the end of the subtree under Interest Name
+    Index::iterator it = name.empty() ? m_index.end() : m_index.lower_bound(name.getSuccessor());
+    for (size_t nCandidates = 0; it != first && nCandidates < MAX_CANDIDATES; ++nCandidates) {
+      --it;
+      if (name.isPrefixOf(it->first) && isMatch(*it->second)) {
+        match = it->second;
+        break;
+      }
+    }
+  }
+
+  if (match == m_lru.end()) {
+    ++m_counters.nMisses;
+    return nullptr;
+  }
+
+  ++m_counters.nHits;
+  m_lru.splice(m_lru.begin(), m_lru, match);
+  return &match->data;
+}
+
+void
+ReplyCache::clear()
+{
+  m_index.clear();
+  m_lru.clear();
+  m_nBytes = 0;
+}
+
+void
+ReplyCache::evict(size_t nBytes)
+{
+  while (!m_lru.empty() && m_nBytes + nBytes > m_capacity) {
+    this->erase(m_index.find(m_lru.back().data.getName()));
+    ++m_counters.nEvictions;
+  }
+}
+
+void
+ReplyCache::erase(Index::iterator it)
+{
+  BOOST_ASSERT(it != m_index.end());
+  m_nBytes -= it->second->wireSize;
+  m_lru.erase(it->second);
+  m_index.erase(it);
+}
+
+} // namespace ndn
@@ -0,0 +1,131 @@
+#ifndef NDNCXXEXT_REPLY_CACHE_HPP
+#define NDNCXXEXT_REPLY_CACHE_HPP
+
+#include "common.hpp"
+#include <list>
+#include <map>
+#include <ndn-cxx/face.hpp>
+
+namespace ndn {
+
+/** \brief cache of Data recently sent by a producer
+ *
+ *  Entries keep Data with its encoded wire, so that a cached reply is sent without re-encoding.
+ *  Total wire size of entries is limited by a byte budget; least recently used entries
+ *  are evicted first. An entry becomes stale after the FreshnessPeriod of its Data,
+ *  or immediately if FreshnessPeriod is unset; a stale entry does not satisfy MustBeFresh.
+ *
+ *  Entries are indexed by Name in canonical order, so that Data under an Interest Name
+ *  are adjacent in the index.
+ */
+class ReplyCache : noncopyable
+{
+public:
+  struct Counters
+  {
+    uint64_t nHits;
+    uint64_t nMisses;
+    uint64_t nInserts;
+    uint64_t nEvictions;
+  };
+
+  ReplyCache();
+
+  /** \brief sets the byte budget, evicting entries as necessary
+   *
+   *  Zero capacity disables the cache.
+   */
+  void
+  setCapacity(size_t capacity);
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  bool
+  isEnabled() const
+  {
+    return m_capacity > 0;
+  }
+
+  /** \brief inserts or replaces an entry for \p data
+   *  \pre \p data is signed
+   *
+   *  Data larger than capacity is not inserted.
+   */
+  void
+  insert(const Data& data);
+
+  /** \return a cached Data that satisfies \p interest, or nullptr
+   *
+   *  Among multiple matches, the first in canonical order is returned,
+   *  or the last if ChildSelector is 1.
+   *  At most MAX_CANDIDATES entries under Interest Name are examined, starting from
+   *  the first (or last if ChildSelector is 1) in canonical order; a Data beyond them
+   *  is not found, and the Interest goes to the listener.
+   */
+  const Data*
+  find(const Interest& interest);
+
+  /** \brief erases all entries
+   */
+  void
+  clear();
+
+  size_t
+  size() const
+  {
+    return m_index.size();
+  }
+
+  /** \return total wire size of entries
+   */
+  size_t
+  getNBytes() const
+  {
+    return m_nBytes;
+  }
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+public:
+  /** \brief maximum number of entries examined in one lookup
+   */
+  static const size_t MAX_CANDIDATES = 16;
+
+private:
+  struct Entry
+  {
+    Data data;
+    time::steady_clock::TimePoint staleTime;
+    size_t wireSize;
+  };
+
+  typedef std::list<Entry> EntryList;
+  typedef std::map<Name, EntryList::iterator> Index;
+
+  /** \brief evicts least recently used entries until \p nBytes more would fit in budget
+   */
+  void
+  evict(size_t nBytes);
+
+  void
+  erase(Index::iterator it);
+
+private:
+  size_t m_capacity;
+  size_t m_nBytes;
+  EntryList m_lru; ///< most recently used at front
+  Index m_index;
+  Counters m_counters;
+};
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_REPLY_CACHE_HPP
@@ -0,0 +1,100 @@
+#include "sharded-client-face.hpp"
+#include "transport/udp-transport.hpp"
+
+namespace ndn {
+
+ShardedClientFace::ShardedClientFace(const util::FaceUri& remote, uint16_t localPort,
+                                     size_t nShardsPerCore)
+{
+  BOOST_ASSERT(localPort != 0);
+  size_t nCores = std::max(std::thread::hardware_concurrency(), 1U);
+  size_t nShards = std::max<size_t>(nCores * nShardsPerCore, 2);
+  for (size_t i = 0; i < nShards; ++i) {
+    unique_ptr<Shard> shard(new Shard);
+    unique_ptr<UdpTransport> transport(new UdpTransport(remote, localPort));
+    transport->shouldReusePort = true;
+    transport->shouldConnect = i == 0;
+    shard->face.reset(new StandaloneClientFace(shard->io, std::move(transport)));
+
+    // every Interest reaches the shared listener table through the root prefix
+    ClientFace& face = *shard->face;
+    face.listen(Name(), [this, &face] (const Name&, const Interest& interest) {
+      this->dispatch(face, interest);
+    }, false);
+    m_shards.push_back(std::move(shard));
+  }
+}
+
+ShardedClientFace::~ShardedClientFace()
+{
+  this->stop();
+}
+
+void
+ShardedClientFace::start()
+{
+  for (unique_ptr<Shard>& shard : m_shards) {
+    BOOST_ASSERT(!shard->thread.joinable());
+    boost::asio::io_service& io = shard->io;
+    shard->thread = std::thread([&io] { io.run(); });
+  }
+}
+
+void
+ShardedClientFace::stop()
+{
+  for (unique_ptr<Shard>& shard : m_shards) {
+    shard->io.stop();
+  }
+  for (unique_ptr<Shard>& shard : m_shards) {
+    if (shard->thread.joinable()) {
+      shard->thread.join();
+    }
+    // a stopped io_service returns immediately from run() until reset
+    shard->io.reset();
+  }
+}
+
+void
+ShardedClientFace::listen(const Name& prefix, const OnShardInterest& onInterest,
+                          bool wantRegister)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_listenersMutex);
+    m_listeners.insert(prefix, onInterest);
+  }
+
+  if (wantRegister) {
+    StandaloneClientFace& face = *m_shards.front()->face;
+    m_shards.front()->io.post([&face, prefix] {
+      face.getPrefixRegistrar().registerPrefix(prefix);
+    });
+  }
+}
+
+void
+ShardedClientFace::unlisten(const Name& prefix)
+{
+  std::lock_guard<std::mutex> lock(m_listenersMutex);
+  m_listeners.erase(prefix);
+}
+
+void
+ShardedClientFace::dispatch(ClientFace& face, const Interest& interest)
+{
+  shared_ptr<const BasicListenerTable<OnShardInterest>::Listener> listener;
+  {
+    std::lock_guard<std::mutex> lock(m_listenersMutex);
+    listener = m_listeners.findLongestPrefixMatch(interest.getName());
+  }
+
+  if (listener == nullptr) {
+    if (face.shouldNackUnmatchedInterest) {
+      face.reply(interest, Nack(Nack::NODATA, interest));
+    }
+    return;
+  }
+  listener->onInterest(face, listener->prefix, interest);
+}
+
+} // namespace ndn
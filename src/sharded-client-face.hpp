@@ -0,0 +1,115 @@
+#ifndef NDNCXXEXT_SHARDED_CLIENT_FACE_HPP
+#define NDNCXXEXT_SHARDED_CLIENT_FACE_HPP
+
+#include "standalone-client-face.hpp"
+#include <ndn-cxx/util/face-uri.hpp>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+
+/** \brief multi-threaded face made of StandaloneClientFace shards
+ *
+ *  Each shard has its own io_service thread, UdpTransport, pending Interest table and scheduler.
+ *  All shards bind the same local UDP port with SO_REUSEPORT. Shard 0 is connected to the
+ *  remote endpoint, normally the forwarder: it receives all datagrams from the remote endpoint,
+ *  and sends prefix registration commands. The other shards are not connected; the kernel
+ *  spreads datagrams from other sources among them by a hash of the source endpoint, and
+ *  a reply sent from a listener goes back to the source of the Interest. Traffic from a single
+ *  source is therefore handled by a single shard; a producer scales with the number of sources.
+ *
+ *  Listeners are kept in one table shared by all shards. A listener is invoked on the thread
+ *  of the shard that received the Interest, with that shard as the face to reply on.
+ */
+class ShardedClientFace : noncopyable
+{
+public:
+  typedef std::function<void(ClientFace& face, const Name& prefix,
+                             const Interest& interest)> OnShardInterest;
+
+  /** \param remote remote endpoint of shard 0
+   *  \param localPort local UDP port shared by all shards
+   *  \param nShardsPerCore number of shards per hardware thread; at least two shards are created
+   */
+  ShardedClientFace(const util::FaceUri& remote, uint16_t localPort, size_t nShardsPerCore = 1);
+
+  /** \brief stops all shards
+   */
+  ~ShardedClientFace();
+
+  /** \brief starts one thread per shard
+   */
+  void
+  start();
+
+  /** \brief stops all shards, and waits for their threads to exit
+   *
+   *  Shards can be started again. Handlers that have not run are kept until then.
+   */
+  void
+  stop();
+
+  size_t
+  size() const
+  {
+    return m_shards.size();
+  }
+
+  /** \return face of a shard
+   *  \note The face must only be accessed on its thread, see getIoService.
+   */
+  ClientFace&
+  getShard(size_t i)
+  {
+    return *m_shards.at(i)->face;
+  }
+
+  boost::asio::io_service&
+  getIoService(size_t i)
+  {
+    return m_shards.at(i)->io;
+  }
+
+public: // producer
+  /** \brief dispatch Interests under \p prefix to \p onInterest, on every shard
+   *
+   *  This is thread-safe, and takes effect on all shards at once.
+   *  \param wantRegister whether to register \p prefix; it is registered through shard 0
+   */
+  void
+  listen(const Name& prefix, const OnShardInterest& onInterest, bool wantRegister = true);
+
+  /** \brief stop dispatching Interests under \p prefix, on every shard
+   *
+   *  This is thread-safe. A listener that is being invoked completes.
+   */
+  void
+  unlisten(const Name& prefix);
+
+private:
+  /** \brief dispatches \p interest received on \p face to the shared listener table
+   */
+  void
+  dispatch(ClientFace& face, const Interest& interest);
+
+private:
+  struct Shard
+  {
+    boost::asio::io_service io;
+    unique_ptr<StandaloneClientFace> face;
+    std::thread thread;
+  };
+
+  std::vector<unique_ptr<Shard>> m_shards;
+
+  /** \brief listeners of all shards
+   *
+   *  A listener is invoked outside of the lock, holding the shared_ptr from lookup.
+   */
+  BasicListenerTable<OnShardInterest> m_listeners;
+  std::mutex m_listenersMutex;
+};
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_SHARDED_CLIENT_FACE_HPP
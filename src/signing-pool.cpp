@@ -0,0 +1,121 @@
+#include "signing-pool.hpp"
+#include "util/logger.hpp"
+
+namespace ndn {
+
+const Name SigningPool::DIGEST_SHA256("ndn:/localhost/identity/digest-sha256");
+
+SigningPool::SigningPool(boost::asio::io_service& io, size_t nWorkers, const Name& identity,
+                         size_t maxQueueDepth)
+  : m_io(io)
+  , m_identity(identity)
+  , m_maxQueueDepth(maxQueueDepth)
+  , m_counters()
+  , m_isAlive(make_shared<bool>(true))
+  , m_shouldStop(false)
+{
+  for (size_t i = 0; i < nWorkers; ++i) {
+    m_workers.emplace_back(&SigningPool::runWorker, this);
+  }
+}
+
+SigningPool::~SigningPool()
+{
+  *m_isAlive = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shouldStop = true;
+  }
+  m_cond.notify_all();
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void
+SigningPool::submit(const Data& data, const OnSigned& onSigned)
+{
+  ++m_counters.nSubmitted;
+
+  if (!m_workers.empty()) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_queue.size() < m_maxQueueDepth) {
+      m_queue.push_back(Job{data, onSigned});
+      m_counters.maxQueueDepth = std::max(m_counters.maxQueueDepth, m_queue.size());
+      lock.unlock();
+      m_cond.notify_one();
+      return;
+    }
+  }
+
+  Data signedData(data);
+  std::string error = this->sign(m_inlineKeyChain, signedData);
+  if (!error.empty()) {
+    ++m_counters.nFailed;
+    LOG("SigningPool error " << error << " " << data.getName());
+    return;
+  }
+  ++m_counters.nInlineSigned;
+  onSigned(signedData);
+}
+
+void
+SigningPool::runWorker()
+{
+  unique_ptr<KeyChain> keyChain;
+  shared_ptr<bool> isAlive = m_isAlive;
+
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cond.wait(lock, [this] { return m_shouldStop || !m_queue.empty(); });
+      if (m_shouldStop) {
+        return;
+      }
+      job = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+
+    std::string error = this->sign(keyChain, job.data);
+    m_io.post([this, isAlive, job, error] {
+      if (!*isAlive) {
+        return;
+      }
+      if (!error.empty()) {
+        ++m_counters.nFailed;
+        LOG("SigningPool error " << error << " " << job.data.getName());
+        return;
+      }
+      ++m_counters.nWorkerSigned;
+      job.onSigned(job.data);
+    });
+  }
+}
+
+std::string
+SigningPool::sign(unique_ptr<KeyChain>& keyChain, Data& data) const
+{
+  try {
+    if (keyChain == nullptr) {
+      keyChain.reset(new KeyChain);
+    }
+
+    if (m_identity == DIGEST_SHA256) {
+      keyChain->signWithSha256(data);
+    }
+    else if (m_identity.empty()) {
+      keyChain->sign(data);
+    }
+    else {
+      keyChain->signByIdentity(data, m_identity);
+    }
+    data.wireEncode();
+  }
+  catch (const std::exception& e) {
+    return e.what();
+  }
+  return "";
+}
+
+} // namespace ndn
@@ -0,0 +1,106 @@
+#ifndef NDNCXXEXT_SIGNING_POOL_HPP
+#define NDNCXXEXT_SIGNING_POOL_HPP
+
+#include "common.hpp"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <ndn-cxx/face.hpp>
+
+namespace ndn {
+
+/** \brief signs Data on a pool of worker threads
+ *
+ *  Each worker has its own KeyChain. Signed Data is posted back to the io thread,
+ *  where the completion callback is invoked. If the queue is full, Data is signed
+ *  inline on the io thread instead, so that the queue depth stays bounded.
+ *
+ *  submit must be invoked on the io thread. This must be destroyed before the io_service
+ *  and before anything referenced by pending completion callbacks; pending callbacks
+ *  are not invoked after destruction.
+ */
+class SigningPool : noncopyable
+{
+public:
+  typedef function<void(const Data& data)> OnSigned;
+
+  /** \brief identity that indicates signing with DigestSha256
+   */
+  static const Name DIGEST_SHA256;
+
+  struct Counters
+  {
+    uint64_t nSubmitted;
+    uint64_t nWorkerSigned; ///< Data signed by workers
+    uint64_t nInlineSigned; ///< Data signed inline because queue was full
+    uint64_t nFailed; ///< Data not signed due to KeyChain error
+    size_t maxQueueDepth; ///< maximum observed queue depth
+  };
+
+  /** \param nWorkers number of worker threads; if zero, all Data are signed inline
+   *  \param identity signing identity; if empty, the default identity is used;
+   *                  if DIGEST_SHA256, Data are signed with DigestSha256
+   *  \param maxQueueDepth maximum number of Data queued for workers
+   */
+  SigningPool(boost::asio::io_service& io, size_t nWorkers, const Name& identity = Name(),
+              size_t maxQueueDepth = 1024);
+
+  /** \brief stops the workers
+   */
+  ~SigningPool();
+
+  /** \brief signs \p data, and then invokes \p onSigned on the io thread
+   *
+   *  \p onSigned may be invoked before this returns, if Data is signed inline.
+   *  It is not invoked if signing fails; the error is logged.
+   */
+  void
+  submit(const Data& data, const OnSigned& onSigned);
+
+  size_t
+  getNWorkers() const
+  {
+    return m_workers.size();
+  }
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+private:
+  struct Job
+  {
+    Data data;
+    OnSigned onSigned;
+  };
+
+  void
+  runWorker();
+
+  /** \brief signs \p data with \p keyChain, which is created if necessary
+   *  \return empty string on success, or error message
+   */
+  std::string
+  sign(unique_ptr<KeyChain>& keyChain, Data& data) const;
+
+private:
+  boost::asio::io_service& m_io;
+  const Name m_identity;
+  const size_t m_maxQueueDepth;
+  Counters m_counters;
+  shared_ptr<bool> m_isAlive;
+  unique_ptr<KeyChain> m_inlineKeyChain;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::deque<Job> m_queue; ///< protected by m_mutex
+  bool m_shouldStop; ///< protected by m_mutex
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace ndn
+
+#endif // NDNCXXEXT_SIGNING_POOL_HPP
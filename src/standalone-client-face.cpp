@@ -1,17 +1,20 @@
 #include "standalone-client-face.hpp"
-#include "util/logger.hpp"
 #include "transport/udp-transport.hpp"
 #include <ndn-cxx/transport/tcp-transport.hpp>
-#include <ndn-cxx/management/nfd-control-command.hpp>
-#include <ndn-cxx/management/nfd-command-options.hpp>
 
 namespace ndn {
 
-StandaloneClientFace::StandaloneClientFace(boost::asio::io_service& io, std::string endpoint)
+StandaloneClientFace::StandaloneClientFace(boost::asio::io_service& io, std::string endpoint,
+                                           unique_ptr<util::SchedulerBase> scheduler)
   : m_io(io)
   , m_ioWork(io)
-  , m_scheduler(io)
+  , m_scheduler(std::move(scheduler))
+  , m_registrar(*this, io)
 {
+  if (m_scheduler == nullptr) {
+    m_scheduler.reset(new util::SchedulerWrapper(io));
+  }
+
   if (endpoint.empty()) {
     char* endpointEnv = getenv("FACE_ENDPOINT");
     if (endpointEnv != nullptr) {
@@ -32,12 +35,17 @@ StandaloneClientFace::StandaloneClientFace(boost::asio::io_service& io, std::str
 }
 
 StandaloneClientFace::StandaloneClientFace(boost::asio::io_service& io,
-                                           unique_ptr<Transport> transport)
+                                           unique_ptr<Transport> transport,
+                                           unique_ptr<util::SchedulerBase> scheduler)
   : m_io(io)
   , m_ioWork(io)
-  , m_scheduler(io)
+  , m_scheduler(std::move(scheduler))
   , m_transport(std::move(transport))
+  , m_registrar(*this, io)
 {
+  if (m_scheduler == nullptr) {
+    m_scheduler.reset(new util::SchedulerWrapper(io));
+  }
   m_transport->connect(io, bind(&StandaloneClientFace::receiveElement, this, _1));
 }
 
@@ -48,7 +56,7 @@ StandaloneClientFace::~StandaloneClientFace()
 util::SchedulerBase&
 StandaloneClientFace::getScheduler()
 {
-  return m_scheduler;
+  return *m_scheduler;
 }
 
 void
@@ -57,25 +65,16 @@ StandaloneClientFace::sendElement(const Block& block)
   m_transport->send(block);
 }
 
-static inline void
-onRegisterFailure(const Name& prefix)
+void
+StandaloneClientFace::sendElement(const Block& header, const Block& payload)
 {
-  LOG("RibRegister timeout " << prefix);
+  m_transport->send(header, payload);
 }
 
 void
 StandaloneClientFace::registerPrefix(const Name& prefix)
 {
-  nfd::ControlParameters parameters;
-  parameters.setName(prefix);
-
-  nfd::RibRegisterCommand command;
-  static const Name COMMAND_PREFIX("/localhost/nfd");
-
-  Interest requestInterest(command.getRequestName(COMMAND_PREFIX, parameters));
-  m_keyChain.sign(requestInterest);
-
-  this->request(requestInterest, bind([]{}), bind([]{}), bind(&onRegisterFailure, prefix));
+  m_registrar.registerPrefix(prefix);
 }
 
 } // namespace ndn
@@ -2,6 +2,7 @@
 #define NDNCXXEXT_STANDALONE_CLIENT_FACE_HPP
 
 #include "client-face.hpp"
+#include "prefix-registrar.hpp"
 
 namespace ndn {
 
@@ -10,13 +11,18 @@ namespace ndn {
 class StandaloneClientFace : public ClientFace
 {
 public:
+  /** \param scheduler scheduler for Interest timeouts and retransmissions;
+   *                   if omitted, util::SchedulerWrapper is used
+   */
   explicit
   StandaloneClientFace(boost::asio::io_service& io,
-                       std::string endpoint = "");
+                       std::string endpoint = "",
+                       unique_ptr<util::SchedulerBase> scheduler = nullptr);
 
   explicit
   StandaloneClientFace(boost::asio::io_service& io,
-                       unique_ptr<Transport> transport);
+                       unique_ptr<Transport> transport,
+                       unique_ptr<util::SchedulerBase> scheduler = nullptr);
 
   virtual
   ~StandaloneClientFace();
@@ -24,19 +30,33 @@ public:
   virtual util::SchedulerBase&
   getScheduler() NDNCXXEXT_DECL_OVERRIDE;
 
+  /** \brief registrar used by listen(prefix, onInterest, wantRegister=true)
+   *
+   *  Producers serving many prefixes may listen without registering,
+   *  and register the prefixes in a batch through the registrar.
+   */
+  PrefixRegistrar&
+  getPrefixRegistrar()
+  {
+    return m_registrar;
+  }
+
 private:
   virtual void
   sendElement(const Block& block) NDNCXXEXT_DECL_OVERRIDE;
 
+  virtual void
+  sendElement(const Block& header, const Block& payload) NDNCXXEXT_DECL_OVERRIDE;
+
   virtual void
   registerPrefix(const Name& prefix) NDNCXXEXT_DECL_OVERRIDE;
 
 private:
   boost::asio::io_service& m_io;
   boost::asio::io_service::work m_ioWork;
-  util::SchedulerWrapper m_scheduler;
+  unique_ptr<util::SchedulerBase> m_scheduler;
   unique_ptr<Transport> m_transport;
-  KeyChain m_keyChain;
+  PrefixRegistrar m_registrar;
 };
 
 } // namespace ndn
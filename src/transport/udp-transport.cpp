@@ -1,10 +1,103 @@
 #include "udp-transport.hpp"
 #include <boost/lexical_cast.hpp>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
 
 namespace ndn {
 
+const size_t UdpTransport::MAX_BATCH_SIZE;
+
+/** \brief free list of MAX_NDN_PACKET_SIZE receive buffers
+ *
+ *  It is shared with Blocks that refer to a receive buffer, so that they can outlive the transport.
+ */
+class UdpTransport::RecvBufferPool : ndn::noncopyable
+{
+public:
+  RecvBufferPool()
+    : capacity(0)
+    , m_nBuffers(0)
+  {
+  }
+
+  ~RecvBufferPool()
+  {
+    for (Buffer* buffer : m_free) {
+      delete buffer;
+    }
+  }
+
+  Buffer*
+  acquire()
+  {
+    if (m_free.empty()) {
+      ++m_nBuffers;
+      return new Buffer(ndn::MAX_NDN_PACKET_SIZE);
+    }
+    Buffer* buffer = m_free.back();
+    m_free.pop_back();
+    return buffer;
+  }
+
+  void
+  release(Buffer* buffer)
+  {
+    if (m_free.size() >= capacity) {
+      --m_nBuffers;
+      delete buffer;
+      return;
+    }
+    m_free.push_back(buffer);
+  }
+
+  size_t
+  size() const
+  {
+    return m_nBuffers;
+  }
+
+public:
+  size_t capacity; ///< maximum number of idle buffers
+
+private:
+  std::vector<Buffer*> m_free;
+  size_t m_nBuffers;
+};
+
+/** \brief returns a receive buffer to the pool when the last Block referring to it is released
+ */
+class UdpTransport::RecvBufferDeleter
+{
+public:
+  explicit
+  RecvBufferDeleter(const shared_ptr<RecvBufferPool>& pool)
+    : m_pool(pool)
+  {
+  }
+
+  void
+  operator()(Buffer* buffer) const
+  {
+    m_pool->release(buffer);
+  }
+
+private:
+  shared_ptr<RecvBufferPool> m_pool;
+};
+
 UdpTransport::UdpTransport(const ndn::util::FaceUri& faceUri, uint16_t localPort)
-  : m_localPort(localPort)
+  : shouldReusePort(false)
+  , shouldConnect(true)
+  , batchSize(1)
+  , recvCopyThreshold(0)
+  , maxRecvBuffers(256)
+  , m_localPort(localPort)
+  , m_source(nullptr)
+  , m_maxBatch(1)
+  , m_isFlushScheduled(false)
+  , m_recvPool(make_shared<RecvBufferPool>())
 {
   if (!faceUri.isCanonical()) {
     throw Error("FaceUri is not canonical");
@@ -36,14 +129,33 @@ UdpTransport::connect(boost::asio::io_service& io, const ReceiveCallback& receiv
     m_sock.reset(new udp::socket(io, udp::v4()));
   }
   else { // fixed local port
-    m_sock.reset(new udp::socket(io, udp::endpoint(udp::v4(), m_localPort)));
+    m_sock.reset(new udp::socket(io, udp::v4()));
+    if (shouldReusePort) {
+#ifdef SO_REUSEPORT
+      typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> ReusePort;
+      m_sock->set_option(ReusePort(true));
+#else
+      throw Error("SO_REUSEPORT is not supported");
+#endif // SO_REUSEPORT
+    }
+    m_sock->bind(udp::endpoint(udp::v4(), m_localPort));
   }
-  m_sock->connect(m_ep);
+  if (shouldConnect) {
+    m_sock->connect(m_ep);
+  }
+  m_flushToken = make_shared<bool>(true);
 
   this->Transport::connect(io, receiveCallback);
   m_isConnected = m_isExpectingData = true;
 
-  this->startReceive();
+  m_maxBatch = std::max<size_t>(std::min(batchSize, MAX_BATCH_SIZE), 1);
+  m_recvPool->capacity = std::max(maxRecvBuffers, m_maxBatch);
+  if (m_maxBatch > 1) {
+    this->startReceiveBatch();
+  }
+  else {
+    this->startReceive();
+  }
 }
 
 void
@@ -53,41 +165,299 @@ UdpTransport::close()
   m_isConnected = m_isExpectingData = false;
   m_sock->cancel();
   m_sock.reset();
+  m_sendQueue.clear();
+  // pending flush handlers are abandoned
+  m_flushToken.reset();
+  m_isFlushScheduled = false;
 }
 
 void
 UdpTransport::send(const Block& wire)
 {
   BOOST_ASSERT(m_sock != nullptr);
-  m_sock->async_send(boost::asio::buffer(wire.wire(), wire.size()),
-      [] (const boost::system::error_code& ec, size_t nTransferred) {
-      });
+  if (m_maxBatch > 1) {
+    m_sendQueue.push_back(Datagram{Block(), wire, this->getDestination()});
+    this->scheduleFlush();
+    return;
+  }
+
+  // handler retains the Block until the send completes
+  auto handler = [wire] (const boost::system::error_code& ec, size_t nTransferred) {};
+  auto buffer = boost::asio::buffer(wire.wire(), wire.size());
+  if (shouldConnect) {
+    m_sock->async_send(buffer, handler);
+  }
+  else {
+    m_sock->async_send_to(buffer, this->getDestination(), handler);
+  }
 }
 
 void
 UdpTransport::send(const Block& header, const Block& payload)
 {
-  BOOST_ASSERT_MSG(false, "not implemented");
+  BOOST_ASSERT(m_sock != nullptr);
+  if (m_maxBatch > 1) {
+    m_sendQueue.push_back(Datagram{header, payload, this->getDestination()});
+    this->scheduleFlush();
+    return;
+  }
+
+  // header and payload are gathered into one datagram by the kernel
+  std::array<boost::asio::const_buffer, 2> buffers{{
+    boost::asio::buffer(header.wire(), header.size()),
+    boost::asio::buffer(payload.wire(), payload.size())
+  }};
+  auto handler = [header, payload] (const boost::system::error_code& ec, size_t nTransferred) {};
+  if (shouldConnect) {
+    m_sock->async_send(buffers, handler);
+  }
+  else {
+    m_sock->async_send_to(buffers, this->getDestination(), handler);
+  }
+}
+
+size_t
+UdpTransport::getNRecvBuffers() const
+{
+  return m_recvPool->size();
+}
+
+void
+UdpTransport::deliver(Buffer* buffer, size_t length,
+                      const boost::asio::ip::udp::endpoint& source)
+{
+  BufferPtr wire;
+  if (length <= recvCopyThreshold) {
+    wire = make_shared<Buffer>(buffer->buf(), length);
+    m_recvPool->release(buffer);
+  }
+  else {
+    // the Block aliases the receive buffer, which is not reused until the Block is released
+    wire = BufferPtr(buffer, RecvBufferDeleter(m_recvPool));
+  }
+
+  Block element;
+  try {
+    element = Block(wire, wire->begin(), wire->begin() + length);
+  }
+  catch (tlv::Error&) {
+    return;
+  }
+
+  // Blocks sent by the receive callback are replies to source
+  m_source = &source;
+  this->receive(element);
+  m_source = nullptr;
 }
 
 void
 UdpTransport::startReceive()
 {
   BOOST_ASSERT(m_sock != nullptr);
-  m_sock->async_receive(boost::asio::buffer(m_buffer, sizeof(m_buffer)),
-      [this] (const boost::system::error_code& ec, size_t nTransferred) {
-        if (!ec && nTransferred > 0) {
-          bool isOk = false;
-          Block element;
-          std::tie(isOk, element) = Block::fromBuffer(m_buffer, sizeof(m_buffer));
-          if (isOk) {
-            this->receive(element);
-          }
+  // the pool is retained by the handler, because the transport may be destructed before
+  // an aborted handler is invoked
+  shared_ptr<RecvBufferPool> pool = m_recvPool;
+  Buffer* buffer = pool->acquire();
+  auto handler = [this, pool, buffer] (const boost::system::error_code& ec, size_t nTransferred) {
+    if (ec == boost::asio::error::operation_aborted) {
+      pool->release(buffer);
+      return;
+    }
+    if (!ec && nTransferred > 0) {
+      this->deliver(buffer, nTransferred, shouldConnect ? m_ep : m_recvSource);
+    }
+    else {
+      pool->release(buffer);
+    }
+    if (m_sock != nullptr) {
+      this->startReceive();
+    }
+  };
+  if (shouldConnect) {
+    m_sock->async_receive(boost::asio::buffer(buffer->buf(), buffer->size()), handler);
+  }
+  else {
+    m_sock->async_receive_from(boost::asio::buffer(buffer->buf(), buffer->size()),
+                               m_recvSource, handler);
+  }
+}
+
+void
+UdpTransport::startReceiveBatch()
+{
+  BOOST_ASSERT(m_sock != nullptr);
+  // wait for readiness, then drain with non-blocking calls
+  m_sock->async_receive(boost::asio::null_buffers(),
+      [this] (const boost::system::error_code& ec, size_t) {
+        if (ec == boost::asio::error::operation_aborted) {
+          return;
+        }
+        this->receiveBatch();
+        if (m_sock != nullptr) {
+          this->startReceiveBatch();
         }
-        this->startReceive();
       });
 }
 
+void
+UdpTransport::receiveBatch()
+{
+  int fd = m_sock->native_handle();
+  Buffer* buffers[MAX_BATCH_SIZE];
+  for (size_t i = 0; i < m_maxBatch; ++i) {
+    buffers[i] = m_recvPool->acquire();
+  }
+  size_t lengths[MAX_BATCH_SIZE];
+  boost::asio::ip::udp::endpoint sources[MAX_BATCH_SIZE];
+  size_t nReceived = 0;
+
+#ifdef NDNCXXEXT_HAVE_RECVMMSG
+  mmsghdr msgs[MAX_BATCH_SIZE];
+  iovec iovs[MAX_BATCH_SIZE];
+  std::memset(msgs, 0, sizeof(msgs));
+  for (size_t i = 0; i < m_maxBatch; ++i) {
+    iovs[i].iov_base = buffers[i]->buf();
+    iovs[i].iov_len = buffers[i]->size();
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = sources[i].data();
+    msgs[i].msg_hdr.msg_namelen = sources[i].capacity();
+  }
+  int res = ::recvmmsg(fd, msgs, m_maxBatch, MSG_DONTWAIT, nullptr);
+  for (int i = 0; i < res; ++i) {
+    lengths[i] = msgs[i].msg_len;
+    sources[i].resize(msgs[i].msg_hdr.msg_namelen);
+  }
+  nReceived = std::max(res, 0);
+#else
+  for (; nReceived < m_maxBatch; ++nReceived) {
+    socklen_t sourceLength = sources[nReceived].capacity();
+    ssize_t res = ::recvfrom(fd, buffers[nReceived]->buf(), buffers[nReceived]->size(),
+                             MSG_DONTWAIT, sources[nReceived].data(), &sourceLength);
+    if (res < 0) {
+      break;
+    }
+    lengths[nReceived] = res;
+    sources[nReceived].resize(sourceLength);
+  }
+#endif // NDNCXXEXT_HAVE_RECVMMSG
+
+  if (nReceived > 0) {
+    ++m_counters.nRecvBatches;
+    m_counters.nRecvDatagrams += nReceived;
+    m_counters.maxRecvBatch = std::max(m_counters.maxRecvBatch, nReceived);
+  }
+
+  for (size_t i = 0; i < m_maxBatch; ++i) {
+    if (i < nReceived && m_isConnected) {
+      this->deliver(buffers[i], lengths[i], shouldConnect ? m_ep : sources[i]);
+    }
+    else {
+      m_recvPool->release(buffers[i]);
+    }
+  }
+}
+
+void
+UdpTransport::scheduleFlush()
+{
+  if (m_isFlushScheduled) {
+    return;
+  }
+  m_isFlushScheduled = true;
+  // Blocks sent by the rest of this io_service turn are coalesced
+  weak_ptr<bool> token = m_flushToken;
+  m_ioService->post([this, token] {
+    if (token.expired()) {
+      // transport is closed or destructed
+      return;
+    }
+    m_isFlushScheduled = false;
+    this->flush();
+  });
+}
+
+void
+UdpTransport::flush()
+{
+  if (m_sock == nullptr) {
+    m_sendQueue.clear();
+    return;
+  }
+
+  // points msg at iovs, which point at header, if any, and payload;
+  // msg carries the destination if the socket is not connected
+  auto fillMsghdr = [this] (const Datagram& datagram, msghdr& msg, iovec* iovs) {
+    size_t n = 0;
+    if (datagram.header.hasWire()) {
+      iovs[n].iov_base = const_cast<uint8_t*>(datagram.header.wire());
+      iovs[n].iov_len = datagram.header.size();
+      ++n;
+    }
+    iovs[n].iov_base = const_cast<uint8_t*>(datagram.payload.wire());
+    iovs[n].iov_len = datagram.payload.size();
+    msg.msg_iov = iovs;
+    msg.msg_iovlen = n + 1;
+    if (!shouldConnect) {
+      msg.msg_name = const_cast<sockaddr*>(datagram.destination.data());
+      msg.msg_namelen = datagram.destination.size();
+    }
+  };
+
+  int fd = m_sock->native_handle();
+  while (!m_sendQueue.empty()) {
+    size_t nBatch = std::min(m_sendQueue.size(), m_maxBatch);
+    int nSent = 0;
+
+#ifdef NDNCXXEXT_HAVE_RECVMMSG
+    mmsghdr msgs[MAX_BATCH_SIZE];
+    iovec iovs[MAX_BATCH_SIZE * 2];
+    std::memset(msgs, 0, sizeof(msgs));
+    for (size_t i = 0; i < nBatch; ++i) {
+      fillMsghdr(m_sendQueue[i], msgs[i].msg_hdr, &iovs[i * 2]);
+    }
+    nSent = ::sendmmsg(fd, msgs, nBatch, MSG_DONTWAIT);
+#else
+    for (; nSent < static_cast<int>(nBatch); ++nSent) {
+      iovec iovs[2];
+      msghdr msg;
+      std::memset(&msg, 0, sizeof(msg));
+      fillMsghdr(m_sendQueue[nSent], msg, iovs);
+      if (::sendmsg(fd, &msg, MSG_DONTWAIT) < 0) {
+        break;
+      }
+    }
+    if (nSent == 0) {
+      nSent = -1; // errno is set by the failed send
+    }
+#endif // NDNCXXEXT_HAVE_RECVMMSG
+
+    if (nSent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // resume when socket becomes writable
+        m_isFlushScheduled = true;
+        m_sock->async_send(boost::asio::null_buffers(),
+            [this] (const boost::system::error_code& ec, size_t) {
+              if (ec == boost::asio::error::operation_aborted) {
+                return;
+              }
+              m_isFlushScheduled = false;
+              this->flush();
+            });
+        return;
+      }
+      // other errors, such as ECONNREFUSED, drop the first datagram, like unbatched mode does
+      nSent = 1;
+    }
+    else {
+      ++m_counters.nSendBatches;
+      m_counters.nSendDatagrams += nSent;
+      m_counters.maxSendBatch = std::max(m_counters.maxSendBatch, static_cast<size_t>(nSent));
+    }
+    m_sendQueue.erase(m_sendQueue.begin(), m_sendQueue.begin() + nSent);
+  }
+}
+
 void
 UdpTransport::pause()
 {
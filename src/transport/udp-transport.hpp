@@ -4,6 +4,7 @@
 #include "../common.hpp"
 #include <ndn-cxx/transport/transport.hpp>
 #include <ndn-cxx/util/face-uri.hpp>
+#include <deque>
 
 namespace ndn {
 
@@ -30,15 +31,140 @@ public:
   virtual void
   resume();
 
+public:
+  /** \brief whether to set SO_REUSEPORT, so that several transports can bind the same local port
+   *
+   *  Among connected sockets sharing a local port, the kernel delivers a datagram to the socket
+   *  connected to its source endpoint. Other datagrams go to one of the unconnected sockets,
+   *  chosen by a hash of the source endpoint. This must be set before connect.
+   */
+  bool shouldReusePort;
+
+  /** \brief whether to connect the socket to the remote endpoint
+   *
+   *  An unconnected socket receives datagrams from any source. A Block sent while a received
+   *  datagram is being delivered goes to the source of that datagram, so that a reply made
+   *  in the receive callback reaches the requester; other Blocks go to the remote endpoint.
+   *  This must be set before connect.
+   */
+  bool shouldConnect;
+
+public: // batching
+  /** \brief maximum number of datagrams per system call
+   *
+   *  When greater than 1, up to this many datagrams are received per readiness event
+   *  with recvmmsg, and Blocks sent within one io_service turn are coalesced into
+   *  sendmmsg calls. This must be set before connect.
+   */
+  size_t batchSize;
+
+  /** \brief upper bound of batchSize
+   */
+  static const size_t MAX_BATCH_SIZE = 64;
+
+  struct BatchCounters
+  {
+    uint64_t nRecvBatches = 0;
+    uint64_t nRecvDatagrams = 0;
+    uint64_t nSendBatches = 0;
+    uint64_t nSendDatagrams = 0;
+    size_t maxRecvBatch = 0;
+    size_t maxSendBatch = 0;
+  };
+
+  /** \brief batch size statistics in batched mode;
+   *         average batch size is number of datagrams divided by number of batches
+   */
+  const BatchCounters&
+  getBatchCounters() const
+  {
+    return m_counters;
+  }
+
+public: // receive buffers
+  /** \brief a datagram no longer than this is copied into a buffer of its own size
+   *
+   *  A longer datagram is passed up in the MAX_NDN_PACKET_SIZE receive buffer without copying,
+   *  and the buffer returns to the pool when all Blocks referring to it are released.
+   *  The default is zero: no datagram is copied. An application that retains received
+   *  packets for long, such as Interests awaiting a delayed reply, may enable copying,
+   *  so that a small retained packet does not pin a whole receive buffer.
+   */
+  size_t recvCopyThreshold;
+
+  /** \brief maximum number of idle receive buffers kept in the pool
+   *
+   *  A receive buffer released while the pool is full is freed.
+   */
+  size_t maxRecvBuffers;
+
+  /** \return number of receive buffers that exist, either idle in the pool or
+   *          referenced by received Blocks
+   */
+  size_t
+  getNRecvBuffers() const;
+
 private:
+  /** \brief an outgoing datagram in batched mode
+   */
+  struct Datagram
+  {
+    Block header; ///< optional; sent before payload if it has wire
+    Block payload;
+    boost::asio::ip::udp::endpoint destination; ///< used if the socket is not connected
+  };
+
+  class RecvBufferPool;
+  class RecvBufferDeleter;
+
+  /** \brief decodes a datagram of \p length octets in \p buffer from \p source,
+   *         and passes it to receive callback
+   *
+   *  \p buffer is either given to the Block or returned to the pool.
+   */
+  void
+  deliver(Buffer* buffer, size_t length, const boost::asio::ip::udp::endpoint& source);
+
+  /** \return destination of a datagram sent now
+   */
+  const boost::asio::ip::udp::endpoint&
+  getDestination() const
+  {
+    return m_source != nullptr ? *m_source : m_ep;
+  }
+
   void
   startReceive();
 
+  void
+  startReceiveBatch();
+
+  void
+  receiveBatch();
+
+  void
+  scheduleFlush();
+
+  void
+  flush();
+
 private:
   uint16_t m_localPort;
   boost::asio::ip::udp::endpoint m_ep;
   unique_ptr<boost::asio::ip::udp::socket> m_sock;
-  uint8_t m_buffer[ndn::MAX_NDN_PACKET_SIZE];
+  boost::asio::ip::udp::endpoint m_recvSource; ///< source of unbatched receive
+  const boost::asio::ip::udp::endpoint* m_source; ///< source of datagram being delivered
+  size_t m_maxBatch; ///< effective batchSize
+
+  std::deque<Datagram> m_sendQueue;
+  bool m_isFlushScheduled;
+  /** \brief expires when the transport is closed or destructed,
+   *         so that a posted flush handler does not touch a closed or destructed transport
+   */
+  shared_ptr<bool> m_flushToken;
+  BatchCounters m_counters;
+
+  shared_ptr<RecvBufferPool> m_recvPool;
 };
 
 } // namespace ndn
@@ -0,0 +1,220 @@
+#include "binary-face-trace-writer.hpp"
+#include "name-hash.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <unordered_map>
+
+namespace ndn {
+namespace util {
+
+const char BinaryFaceTraceWriter::MAGIC[8] = {'N', 'D', 'N', 'F', 'T', 'R', 'C', '1'};
+
+static const time::milliseconds DRAIN_INTERVAL(10);
+
+template<typename T>
+static inline void
+writeValue(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+static inline bool
+readValue(std::istream& is, T& value)
+{
+  return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static size_t
+roundUpToPowerOf2(size_t n)
+{
+  size_t size = 1;
+  while (size < n) {
+    size <<= 1;
+  }
+  return size;
+}
+
+BinaryFaceTraceWriter::BinaryFaceTraceWriter(const std::string& filename, size_t capacity,
+                                             size_t nameTableSize)
+  : m_file(filename, std::ios::binary | std::ios::trunc)
+  , m_head(0)
+  , m_tail(0)
+  , m_nDropped(0)
+  , m_nextNameId(0)
+  , m_shouldStop(false)
+{
+  size_t size = roundUpToPowerOf2(capacity);
+  m_ring.resize(size);
+  m_mask = size - 1;
+
+  size = roundUpToPowerOf2(nameTableSize);
+  m_nameTable.resize(size);
+  for (NameSlot& slot : m_nameTable) {
+    slot.hasName = false;
+  }
+  m_nameTableMask = size - 1;
+
+  // header: magic, system clock in microseconds, steady clock in nanoseconds;
+  // the pair of clocks allows record timestamps to be converted to wallclock
+  m_file.write(MAGIC, sizeof(MAGIC));
+  writeValue<int64_t>(m_file, time::duration_cast<time::microseconds>(
+                              time::system_clock::now().time_since_epoch()).count());
+  writeValue<int64_t>(m_file, time::duration_cast<time::nanoseconds>(
+                              time::steady_clock::now().time_since_epoch()).count());
+
+  m_drainThread = std::thread(&BinaryFaceTraceWriter::drainLoop, this);
+}
+
+BinaryFaceTraceWriter::~BinaryFaceTraceWriter()
+{
+  for (signal::Connection& connection : m_connections) {
+    connection.disconnect();
+  }
+  m_shouldStop = true;
+  m_drainThread.join();
+}
+
+void
+BinaryFaceTraceWriter::connect(ClientFace& face)
+{
+  m_connections.push_back(face.trace.connect(
+    bind(&BinaryFaceTraceWriter::onTrace, this, _1, _2, _3)));
+}
+
+void
+BinaryFaceTraceWriter::onTrace(ClientFace::TraceEventKind evt,
+                               const Interest& interest, NackCode nackCode)
+{
+  uint64_t head = m_head.load(std::memory_order_relaxed);
+  if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+    ++m_nDropped;
+    return;
+  }
+
+  FaceTraceRecord& record = m_ring[head & m_mask];
+  record.timestamp = time::duration_cast<time::nanoseconds>(
+                     time::steady_clock::now().time_since_epoch()).count();
+  record.nameId = this->internName(interest.getName());
+  record.nonce = interest.hasNonce() ? interest.getNonce() : 0;
+  record.kind = static_cast<uint8_t>(evt);
+  record.nackCode = static_cast<uint8_t>(nackCode);
+  m_head.store(head + 1, std::memory_order_release);
+}
+
+uint32_t
+BinaryFaceTraceWriter::internName(const Name& name)
+{
+  size_t h = hashName(name);
+  NameSlot& slot = m_nameTable[h & m_nameTableMask];
+  if (slot.hasName && slot.hash == h && slot.name == name) {
+    return slot.id;
+  }
+
+  // an evicted id is not reused, because records referencing it may still be in the ring
+  slot.hasName = true;
+  slot.hash = h;
+  slot.id = m_nextNameId++;
+  slot.name = name;
+  {
+    // the name is published before any record referencing it
+    std::lock_guard<std::mutex> lock(m_pendingNamesMutex);
+    m_pendingNames.emplace_back(slot.id, name);
+  }
+  return slot.id;
+}
+
+void
+BinaryFaceTraceWriter::drainLoop()
+{
+  while (!m_shouldStop) {
+    this->drain();
+    std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_INTERVAL.count()));
+  }
+  this->drain();
+}
+
+void
+BinaryFaceTraceWriter::drain()
+{
+  // names referenced by records before head are already pending
+  uint64_t head = m_head.load(std::memory_order_acquire);
+  {
+    std::lock_guard<std::mutex> lock(m_pendingNamesMutex);
+    m_drainNames.swap(m_pendingNames);
+  }
+
+  for (const auto& pair : m_drainNames) {
+    std::string uri = pair.second.toUri();
+    writeValue<uint8_t>(m_file, ENTRY_NAME);
+    writeValue<uint32_t>(m_file, pair.first);
+    writeValue<uint32_t>(m_file, uri.size());
+    m_file.write(uri.data(), uri.size());
+  }
+  m_drainNames.clear();
+
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+  for (; tail != head; ++tail) {
+    writeValue<uint8_t>(m_file, ENTRY_RECORD);
+    writeValue(m_file, m_ring[tail & m_mask]);
+  }
+  m_tail.store(tail, std::memory_order_release);
+  m_file.flush();
+}
+
+bool
+decodeBinaryFaceTrace(std::istream& is, std::ostream& os)
+{
+  char magic[sizeof(BinaryFaceTraceWriter::MAGIC)];
+  int64_t systemStart = 0, steadyStart = 0;
+  if (!is.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), BinaryFaceTraceWriter::MAGIC) ||
+      !readValue(is, systemStart) || !readValue(is, steadyStart)) {
+    return false;
+  }
+
+  static const int64_t ONE_SECOND = 1000000;
+  std::unordered_map<uint32_t, std::string> names;
+  uint8_t type = 0;
+  while (readValue(is, type)) {
+    switch (type) {
+    case BinaryFaceTraceWriter::ENTRY_NAME: {
+      uint32_t id = 0, length = 0;
+      if (!readValue(is, id) || !readValue(is, length)) {
+        return false;
+      }
+      std::string& name = names[id];
+      name.resize(length);
+      if (!is.read(&name[0], length)) {
+        return false;
+      }
+      break;
+    }
+    case BinaryFaceTraceWriter::ENTRY_RECORD: {
+      FaceTraceRecord record;
+      if (!readValue(is, record)) {
+        return false;
+      }
+      int64_t timestamp = systemStart + (record.timestamp - steadyStart) / 1000;
+      char timestampStr[32];
+      std::snprintf(timestampStr, sizeof(timestampStr), "%" PRId64 ".%06" PRId64,
+                    timestamp / ONE_SECOND, timestamp % ONE_SECOND);
+      auto evt = static_cast<ClientFace::TraceEventKind>(record.kind);
+      os << timestampStr << " [FaceTrace] " << names[record.nameId] << " " << evt << " 0";
+      if (evt == ClientFace::TraceEventKind::NACK_FROM ||
+          evt == ClientFace::TraceEventKind::NACK_TO) {
+        os << " " << static_cast<NackCode>(record.nackCode);
+      }
+      os << "\n";
+      break;
+    }
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace util
+} // namespace ndn
@@ -0,0 +1,127 @@
+#ifndef NDNCXXEXT_UTIL_BINARY_FACE_TRACE_WRITER_HPP
+#define NDNCXXEXT_UTIL_BINARY_FACE_TRACE_WRITER_HPP
+
+#include "common.hpp"
+#include "../client-face.hpp"
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+namespace util {
+
+/** \brief compact trace event
+ */
+struct FaceTraceRecord
+{
+  int64_t timestamp; ///< steady clock, nanoseconds since epoch
+  uint32_t nameId; ///< interned Interest Name
+  uint32_t nonce;
+  uint8_t kind; ///< ClientFace::TraceEventKind
+  uint8_t nackCode;
+};
+
+/** \brief writes ClientFace trace events into a binary file
+ *
+ *  Each event is stored as a FaceTraceRecord in a preallocated ring buffer,
+ *  with Interest Name interned to an id; events are dropped if the ring buffer is full.
+ *  A background thread drains the ring buffer into the file.
+ *
+ *  Names are interned in a direct-mapped table indexed by name hash. A slot is reused
+ *  only if it holds the same name, otherwise the new name takes over the slot and is
+ *  assigned a new id, so that the table is bounded and a hash collision never merges
+ *  two names. A new name is converted to URI on the background thread.
+ *  decodeBinaryFaceTrace converts the file to FaceTraceWriter text format.
+ *
+ *  The file is written in host byte order.
+ *  All connected faces must run on the same thread.
+ */
+class BinaryFaceTraceWriter : noncopyable
+{
+public:
+  /** \param capacity ring buffer capacity, rounded up to a power of 2
+   *  \param nameTableSize name intern table size, rounded up to a power of 2
+   */
+  explicit
+  BinaryFaceTraceWriter(const std::string& filename, size_t capacity = 65536,
+                        size_t nameTableSize = 4096);
+
+  /** \brief disconnects from faces, drains remaining records, and closes the file
+   */
+  ~BinaryFaceTraceWriter();
+
+  void
+  connect(ClientFace& face);
+
+  /** \return number of events dropped due to full ring buffer
+   */
+  size_t
+  getNDropped() const
+  {
+    return m_nDropped;
+  }
+
+public:
+  static const char MAGIC[8];
+
+  enum EntryType : uint8_t {
+    ENTRY_NAME = 1,
+    ENTRY_RECORD = 2
+  };
+
+private:
+  void
+  onTrace(ClientFace::TraceEventKind evt, const Interest& interest, NackCode nackCode);
+
+  uint32_t
+  internName(const Name& name);
+
+  void
+  drainLoop();
+
+  /** \brief writes pending names and records into the file
+   */
+  void
+  drain();
+
+private:
+  std::ofstream m_file;
+  std::vector<signal::Connection> m_connections;
+
+  // ring buffer: written by io thread, read by drain thread
+  std::vector<FaceTraceRecord> m_ring;
+  size_t m_mask;
+  std::atomic<uint64_t> m_head;
+  std::atomic<uint64_t> m_tail;
+  size_t m_nDropped;
+
+  // name interning: m_nameTable is accessed by io thread only
+  struct NameSlot
+  {
+    bool hasName;
+    size_t hash;
+    uint32_t id;
+    Name name;
+  };
+  std::vector<NameSlot> m_nameTable;
+  size_t m_nameTableMask;
+  uint32_t m_nextNameId;
+  std::mutex m_pendingNamesMutex;
+  std::vector<std::pair<uint32_t, Name>> m_pendingNames;
+  std::vector<std::pair<uint32_t, Name>> m_drainNames;
+
+  std::atomic<bool> m_shouldStop;
+  std::thread m_drainThread;
+};
+
+/** \brief converts a binary trace file to FaceTraceWriter text format
+ *  \return whether input is a valid binary trace
+ */
+bool
+decodeBinaryFaceTrace(std::istream& is, std::ostream& os);
+
+} // namespace util
+} // namespace ndn
+
+#endif // NDNCXXEXT_UTIL_BINARY_FACE_TRACE_WRITER_HPP
@@ -15,26 +15,12 @@ FaceTraceWriter::onTrace(ClientFace::TraceEventKind evt,
                          const Interest& interest, NackCode nackCode)
 {
   switch (evt) {
-  case ClientFace::TraceEventKind::INTEREST_TO:
-    LOG("[FaceTrace] " << interest.getName() << " interestTo 0");
-    break;
-  case ClientFace::TraceEventKind::DATA_FROM:
-    LOG("[FaceTrace] " << interest.getName() << " dataFrom 0");
-    break;
   case ClientFace::TraceEventKind::NACK_FROM:
-    LOG("[FaceTrace] " << interest.getName() << " nackFrom 0 " << nackCode);
-    break;
-  case ClientFace::TraceEventKind::TIMEOUT_FROM:
-    LOG("[FaceTrace] " << interest.getName() << " timeoutFrom 0");
-    break;
-  case ClientFace::TraceEventKind::INTEREST_FROM:
-    LOG("[FaceTrace] " << interest.getName() << " interestFrom 0");
-    break;
-  case ClientFace::TraceEventKind::DATA_TO:
-    LOG("[FaceTrace] " << interest.getName() << " dataTo 0");
-    break;
   case ClientFace::TraceEventKind::NACK_TO:
-    LOG("[FaceTrace] " << interest.getName() << " nackTo 0 " << nackCode);
+    LOG("[FaceTrace] " << interest.getName() << " " << evt << " 0 " << nackCode);
+    break;
+  default:
+    LOG("[FaceTrace] " << interest.getName() << " " << evt << " 0");
     break;
   }
 }
@@ -0,0 +1,58 @@
+#include "memory-pool.hpp"
+
+namespace ndn {
+namespace util {
+
+const size_t MemoryPool::GRANULARITY;
+
+MemoryPool::MemoryPool()
+  : m_nAllocations(0)
+  , m_nSystemAllocations(0)
+  , m_nInUse(0)
+{
+}
+
+MemoryPool::~MemoryPool()
+{
+  for (FreeBlock* block : m_freeLists) {
+    while (block != nullptr) {
+      FreeBlock* next = block->next;
+      ::operator delete(block);
+      block = next;
+    }
+  }
+}
+
+void*
+MemoryPool::allocate(size_t size)
+{
+  size_t sizeClass = getSizeClass(size);
+  ++m_nAllocations;
+  ++m_nInUse;
+
+  if (sizeClass < m_freeLists.size() && m_freeLists[sizeClass] != nullptr) {
+    FreeBlock* block = m_freeLists[sizeClass];
+    m_freeLists[sizeClass] = block->next;
+    return block;
+  }
+
+  ++m_nSystemAllocations;
+  return ::operator new(sizeClass * GRANULARITY);
+}
+
+void
+MemoryPool::deallocate(void* p, size_t size)
+{
+  size_t sizeClass = getSizeClass(size);
+  if (sizeClass >= m_freeLists.size()) {
+    m_freeLists.resize(sizeClass + 1, nullptr);
+  }
+
+  FreeBlock* block = static_cast<FreeBlock*>(p);
+  block->next = m_freeLists[sizeClass];
+  m_freeLists[sizeClass] = block;
+  --m_nInUse;
+}
+
+} // namespace util
+} // namespace ndn
@@ -0,0 +1,111 @@
+#ifndef NDNCXXEXT_UTIL_MEMORY_POOL_HPP
+#define NDNCXXEXT_UTIL_MEMORY_POOL_HPP
+
+#include "common.hpp"
+#include <algorithm>
+
+namespace ndn {
+namespace util {
+
+/** \brief pool of memory blocks, with one free list per size class
+ *
+ *  Freed blocks are kept for reuse and never returned to the system until the pool
+ *  is destroyed, so that a steady workload obtains no new blocks from the system.
+ *  Together with recycled pending Interest entries and TimingWheelScheduler, a steady
+ *  request/response cycle makes no heap allocation other than packet encoding and decoding,
+ *  provided that request callbacks fit within std::function's inline storage.
+ *  This is not thread-safe.
+ */
+class MemoryPool : noncopyable
+{
+public:
+  MemoryPool();
+
+  /** \brief frees blocks in free lists
+   *
+   *  Blocks still in use are not freed.
+   */
+  ~MemoryPool();
+
+  void*
+  allocate(size_t size);
+
+  void
+  deallocate(void* p, size_t size);
+
+  /** \brief allocates and constructs an object
+   */
+  template<typename T, typename... Args>
+  T*
+  construct(Args&&... args)
+  {
+    void* p = this->allocate(sizeof(T));
+    try {
+      return new (p) T(std::forward<Args>(args)...);
+    }
+    catch (...) {
+      this->deallocate(p, sizeof(T));
+      throw;
+    }
+  }
+
+  /** \brief destructs and deallocates an object
+   */
+  template<typename T>
+  void
+  destroy(T* p)
+  {
+    p->~T();
+    this->deallocate(p, sizeof(T));
+  }
+
+public: // counters
+  /** \return number of blocks handed out
+   */
+  size_t
+  getNAllocations() const
+  {
+    return m_nAllocations;
+  }
+
+  /** \return number of blocks obtained from the system
+   */
+  size_t
+  getNSystemAllocations() const
+  {
+    return m_nSystemAllocations;
+  }
+
+  /** \return number of blocks in use
+   */
+  size_t
+  getNInUse() const
+  {
+    return m_nInUse;
+  }
+
+private:
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  static const size_t GRANULARITY = 16;
+
+  static size_t
+  getSizeClass(size_t size)
+  {
+    return (std::max(size, sizeof(FreeBlock)) + GRANULARITY - 1) / GRANULARITY;
+  }
+
+private:
+  std::vector<FreeBlock*> m_freeLists; ///< indexed by size class
+  size_t m_nAllocations;
+  size_t m_nSystemAllocations;
+  size_t m_nInUse;
+};
+
+} // namespace util
+} // namespace ndn
+
+#endif // NDNCXXEXT_UTIL_MEMORY_POOL_HPP
@@ -0,0 +1,87 @@
+#include "nack-backoff.hpp"
+#include <algorithm>
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndn {
+namespace util {
+
+NackBackoffExponential::NackBackoffExponential(const time::milliseconds& base,
+                                               const time::milliseconds& cap,
+                                               Jitter jitter, const RandomSource& randomSource)
+  : m_base(base)
+  , m_cap(cap)
+  , m_jitter(jitter)
+  , m_random(randomSource)
+  , m_prev(base)
+{
+  if (m_random == nullptr) {
+    m_random = &random::generateWord32;
+  }
+}
+
+time::milliseconds
+NackBackoffExponential::randomBetween(const time::milliseconds& min,
+                                      const time::milliseconds& max)
+{
+  if (max <= min) {
+    return min;
+  }
+  uint64_t range = static_cast<uint64_t>((max - min).count()) + 1;
+  return min + time::milliseconds(m_random() % range);
+}
+
+time::milliseconds
+NackBackoffExponential::operator()(int nNacks, const Nack& nack)
+{
+  if (m_jitter == JITTER_DECORRELATED) {
+    m_prev = std::min(m_cap, randomBetween(m_base, m_prev * 3));
+    return m_prev;
+  }
+
+  time::milliseconds delay = m_base;
+  for (int i = 1; i < nNacks && delay < m_cap; ++i) {
+    delay *= 2;
+  }
+  delay = std::min(delay, m_cap);
+
+  if (m_jitter == JITTER_FULL) {
+    delay = randomBetween(time::milliseconds::zero(), delay);
+  }
+  return delay;
+}
+
+NackBackoffPerCode::NackBackoffPerCode(const NackBackoff& defaultBackoff)
+  : m_default(defaultBackoff)
+{
+}
+
+NackBackoffPerCode&
+NackBackoffPerCode::set(NackCode code, const NackBackoff& backoff)
+{
+  m_backoffs[code] = backoff;
+  return *this;
+}
+
+time::milliseconds
+NackBackoffPerCode::operator()(int nNacks, const Nack& nack)
+{
+  auto it = m_backoffs.find(nack.getCode());
+  if (it == m_backoffs.end()) {
+    return m_default(nNacks, nack);
+  }
+  return it->second(nNacks, nack);
+}
+
+NackBackoffRetryAfter::NackBackoffRetryAfter(const NackBackoff& inner)
+  : m_inner(inner)
+{
+}
+
+time::milliseconds
+NackBackoffRetryAfter::operator()(int nNacks, const Nack& nack)
+{
+  return nack.getRetryAfter() + m_inner(nNacks, nack);
+}
+
+} // namespace util
+} // namespace ndn
@@ -0,0 +1,134 @@
+#ifndef NDNCXXEXT_UTIL_NACK_BACKOFF_HPP
+#define NDNCXXEXT_UTIL_NACK_BACKOFF_HPP
+
+#include "common.hpp"
+#include "../nack.hpp"
+#include <map>
+
+namespace ndn {
+namespace util {
+
+/** \brief determines how long to wait before retrying a request after a NACK
+ *  \param nNacks number of NACKs received by the request, including \p nack
+ *
+ *  A policy is copied into each request, so that it may keep per-request state.
+ */
+typedef std::function<time::milliseconds(int nNacks, const Nack& nack)> NackBackoff;
+
+/** \brief waits a fixed delay
+ */
+class NackBackoffFixed
+{
+public:
+  explicit
+  NackBackoffFixed(const time::milliseconds& delay)
+    : m_delay(delay)
+  {
+  }
+
+  time::milliseconds
+  operator()(int nNacks, const Nack& nack)
+  {
+    return m_delay;
+  }
+
+private:
+  time::milliseconds m_delay;
+};
+
+/** \brief waits an exponentially increasing delay, with optional jitter
+ *
+ *  Jitter spreads retries of requests NACKed at the same time, so that they do not
+ *  arrive at an overloaded producer together again.
+ */
+class NackBackoffExponential
+{
+public:
+  enum Jitter {
+    /** \brief base * 2^(nNacks-1), up to cap
+     */
+    JITTER_NONE,
+    /** \brief uniformly random between zero and base * 2^(nNacks-1), up to cap
+     */
+    JITTER_FULL,
+    /** \brief uniformly random between base and three times the previous delay, up to cap
+     */
+    JITTER_DECORRELATED
+  };
+
+  /** \brief source of uniformly random 32-bit words for jitter
+   */
+  typedef std::function<uint32_t()> RandomSource;
+
+  /** \param randomSource source of jitter; if nullptr, ndn::random::generateWord32 is used.
+   *         The policy is copied into each request, so the source should refer to a shared
+   *         generator, such as a seeded boost::random::mt19937 held by reference;
+   *         a seeded generator makes delays reproducible.
+   */
+  NackBackoffExponential(const time::milliseconds& base, const time::milliseconds& cap,
+                         Jitter jitter = JITTER_FULL,
+                         const RandomSource& randomSource = nullptr);
+
+  time::milliseconds
+  operator()(int nNacks, const Nack& nack);
+
+private:
+  /** \return uniformly random duration between \p min and \p max, inclusive
+   */
+  time::milliseconds
+  randomBetween(const time::milliseconds& min, const time::milliseconds& max);
+
+private:
+  time::milliseconds m_base;
+  time::milliseconds m_cap;
+  Jitter m_jitter;
+  RandomSource m_random;
+  time::milliseconds m_prev;
+};
+
+/** \brief chooses a policy by NackCode
+ */
+class NackBackoffPerCode
+{
+public:
+  /** \param defaultBackoff policy for codes without a specific policy
+   */
+  explicit
+  NackBackoffPerCode(const NackBackoff& defaultBackoff);
+
+  /** \brief sets the policy for \p code
+   */
+  NackBackoffPerCode&
+  set(NackCode code, const NackBackoff& backoff);
+
+  time::milliseconds
+  operator()(int nNacks, const Nack& nack);
+
+private:
+  NackBackoff m_default;
+  std::map<NackCode, NackBackoff> m_backoffs;
+};
+
+/** \brief honors the retry-after hint in NACK
+ *
+ *  If NACK carries a retry-after hint, the delay is the hint plus the delay of \p inner;
+ *  otherwise, the delay is that of \p inner. Since the hint is likely the same for
+ *  requests NACKed at the same time, \p inner should have jitter.
+ */
+class NackBackoffRetryAfter
+{
+public:
+  explicit
+  NackBackoffRetryAfter(const NackBackoff& inner);
+
+  time::milliseconds
+  operator()(int nNacks, const Nack& nack);
+
+private:
+  NackBackoff m_inner;
+};
+
+} // namespace util
+} // namespace ndn
+
+#endif // NDNCXXEXT_UTIL_NACK_BACKOFF_HPP
@@ -0,0 +1,64 @@
+#ifndef NDNCXXEXT_UTIL_NAME_HASH_HPP
+#define NDNCXXEXT_UTIL_NAME_HASH_HPP
+
+#include "common.hpp"
+#include <ndn-cxx/name.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace ndn {
+namespace util {
+
+/** \brief hash of the empty name
+ */
+static const size_t EMPTY_NAME_HASH = 0x9e3779b9;
+
+/** \brief computes hash of a name component
+ */
+inline size_t
+hashComponent(const name::Component& comp)
+{
+  size_t seed = comp.type();
+  boost::hash_range(seed, comp.value_begin(), comp.value_end());
+  return seed;
+}
+
+/** \brief computes hash of a name prefix extended by one component
+ *  \param prefixHash hash of the prefix
+ *
+ *  Starting from EMPTY_NAME_HASH and extending one component at a time,
+ *  the hashes of all prefixes of a name are computed in one pass.
+ */
+inline size_t
+extendNameHash(size_t prefixHash, const name::Component& comp)
+{
+  boost::hash_combine(prefixHash, hashComponent(comp));
+  return prefixHash;
+}
+
+/** \brief computes hash of a name
+ */
+inline size_t
+hashName(const Name& name)
+{
+  size_t h = EMPTY_NAME_HASH;
+  for (const name::Component& comp : name) {
+    h = extendNameHash(h, comp);
+  }
+  return h;
+}
+
+/** \brief hash functor for name components
+ */
+struct ComponentHash
+{
+  size_t
+  operator()(const name::Component& comp) const
+  {
+    return hashComponent(comp);
+  }
+};
+
+} // namespace util
+} // namespace ndn
+
+#endif // NDNCXXEXT_UTIL_NAME_HASH_HPP
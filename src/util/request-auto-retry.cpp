@@ -1,8 +1,16 @@
 #include "request-auto-retry.hpp"
+#include <algorithm>
 
 namespace ndn {
 namespace util {
 
+/** \brief state of a request
+ *
+ *  The first transmission sends the caller's Interest as is, and the pending Interest entry
+ *  keeps the only copy. The Interest is copied into this object only for a retransmission,
+ *  which needs a new Nonce. Callbacks given to the face capture only \p this, so that they
+ *  are stored within std::function without heap allocation.
+ */
 class RequestAutoRetry
 {
 public:
@@ -10,30 +18,37 @@ public:
                    const OnData& onData, const OnTimeout& onFail,
                    const AutoRetryDecision& retryDecision,
                    const time::milliseconds& retxInterval,
-                   const time::milliseconds& nackRetxDelay);
+                   const NackBackoff& nackBackoff);
 
 private:
   void
-  sendInterest();
+  sendInterest(const Interest& interest);
 
+  /** \brief sends a copy of \p interest with a new Nonce
+   */
   void
-  handleData(Data& data);
+  retransmit(const Interest& interest);
 
   void
-  handleNack(const Nack& nack);
+  handleData(const Interest& interest, Data& data);
 
   void
-  handleTimeout();
+  handleNack(const Interest& interest, const Nack& nack);
+
+  void
+  handleTimeout(const Interest& interest);
 
 private:
   ClientFace& m_face;
   int m_nSent;
-  Interest m_interest;
+  int m_nTimeouts;
+  int m_nNacks;
+  Interest m_interest; ///< Interest being retransmitted
   OnData m_onData;
   OnTimeout m_onFail;
   AutoRetryDecision m_retryDecision;
   time::milliseconds m_retxInterval;
-  time::milliseconds m_nackRetxDelay;
+  NackBackoff m_nackBackoff;
 };
 
 
@@ -41,67 +56,93 @@ RequestAutoRetry::RequestAutoRetry(ClientFace& face, const Interest& interest,
                                    const OnData& onData, const OnTimeout& onFail,
                                    const AutoRetryDecision& retryDecision,
                                    const time::milliseconds& retxInterval,
-                                   const time::milliseconds& nackRetxDelay)
+                                   const NackBackoff& nackBackoff)
   : m_face(face)
   , m_nSent(0)
-  , m_interest(interest)
+  , m_nTimeouts(0)
+  , m_nNacks(0)
   , m_onData(onData)
   , m_onFail(onFail)
   , m_retryDecision(retryDecision)
   , m_retxInterval(retxInterval)
-  , m_nackRetxDelay(nackRetxDelay)
+  , m_nackBackoff(nackBackoff)
 {
   if (!static_cast<bool>(m_onData))
     m_onData = bind([]{});
   if (!static_cast<bool>(m_onFail))
     m_onFail = bind([]{});
 
-  m_interest.setNonce(1);
-  this->sendInterest();
+  this->sendInterest(interest);
 }
 
 void
-RequestAutoRetry::sendInterest()
+RequestAutoRetry::sendInterest(const Interest& interest)
 {
-  m_interest.refreshNonce();
-  BOOST_ASSERT(m_interest.hasNonce());
+  time::milliseconds retxInterval = m_retxInterval;
+  if (retxInterval == AUTO_RETRY_ADAPTIVE) {
+    time::nanoseconds rto = m_face.getRttEstimator().getBackoffRto(m_nTimeouts + 1);
+    retxInterval = std::max(time::duration_cast<time::milliseconds>(rto),
+                            time::milliseconds(1));
+  }
 
   ++m_nSent;
-  m_face.request(m_interest,
-                 bind(&RequestAutoRetry::handleData, this, _2),
-                 bind(&RequestAutoRetry::handleNack, this, _2),
-                 bind(&RequestAutoRetry::handleTimeout, this),
-                 m_retxInterval);
+  m_face.request(interest,
+                 [this] (const Interest& interest, Data& data) {
+                   this->handleData(interest, data);
+                 },
+                 [this] (const Interest& interest, const Nack& nack) {
+                   this->handleNack(interest, nack);
+                 },
+                 [this] (const Interest& interest) {
+                   this->handleTimeout(interest);
+                 },
+                 retxInterval, m_nSent > 1);
+}
+
+void
+RequestAutoRetry::retransmit(const Interest& interest)
+{
+  if (&interest != &m_interest) {
+    m_interest = interest;
+  }
+  // an Interest without Nonce gets a random Nonce when encoded
+  m_interest.refreshNonce();
+  this->sendInterest(m_interest);
 }
 
 void
-RequestAutoRetry::handleData(Data& data)
+RequestAutoRetry::handleData(const Interest& interest, Data& data)
 {
-  m_onData(m_interest, data);
-  delete this;
+  m_onData(interest, data);
+  m_face.getRequestPool().destroy(this);
 }
 
 void
-RequestAutoRetry::handleNack(const Nack& nack)
+RequestAutoRetry::handleNack(const Interest& interest, const Nack& nack)
 {
+  ++m_nNacks;
   if (m_retryDecision(m_nSent, false, nack.getCode())) {
-    m_face.getScheduler().schedule(m_nackRetxDelay, [this] { this->sendInterest(); });
+    // interest refers to the pending Interest entry, which is recycled after this callback
+    m_interest = interest;
+    m_face.getScheduler().schedule(m_nackBackoff(m_nNacks, nack),
+                                   [this] { this->retransmit(m_interest); });
   }
   else {
-    m_onFail(m_interest);
-    delete this;
+    m_onFail(interest);
+    m_face.getRequestPool().destroy(this);
   }
 }
 
 void
-RequestAutoRetry::handleTimeout()
+RequestAutoRetry::handleTimeout(const Interest& interest)
 {
+  ++m_nTimeouts;
   if (m_retryDecision(m_nSent, true, Nack::NONE)) {
-    this->sendInterest();
+    this->retransmit(interest);
   }
   else {
-    m_onFail(m_interest);
-    delete this;
+    m_onFail(interest);
+    m_face.getRequestPool().destroy(this);
   }
 }
 
@@ -110,10 +151,11 @@ requestAutoRetry(ClientFace& face, const Interest& interest,
                  const OnData& onData, const OnTimeout& onFail,
                  const AutoRetryDecision& retryDecision,
                  const time::milliseconds& retxInterval,
-                 const time::milliseconds& nackRetxDelay)
+                 const NackBackoff& nackBackoff)
 {
-  new RequestAutoRetry(face, interest, onData, onFail, retryDecision,
-                       retxInterval, nackRetxDelay);
+  // deleted after onData or onFail
+  face.getRequestPool().construct<RequestAutoRetry>(face, interest, onData, onFail,
+                                                    retryDecision, retxInterval, nackBackoff);
 }
 
 } // namespace util
@@ -2,6 +2,7 @@
 #define NDNCXXEXT_UTIL_REQUEST_AUTO_RETRY_HPP
 
 #include "common.hpp"
+#include "nack-backoff.hpp"
 #include "../client-face.hpp"
 
 namespace ndn {
@@ -37,14 +38,27 @@ private:
   int m_nMaxSent;
 };
 
+/** \brief retxInterval that selects adaptive retransmission timeout
+ *
+ *  Each transmission times out after the RTO of face's RTT estimator,
+ *  doubled for each earlier timeout of the same request.
+ */
+static const time::milliseconds AUTO_RETRY_ADAPTIVE = time::milliseconds::max();
+
 /** \brief send an Interest repeatedly until a Data comes back
+ *  \param retxInterval timeout of each transmission, or AUTO_RETRY_ADAPTIVE;
+ *                      Interest lifetime is used if it is shorter
+ *  \param nackBackoff delay before retrying after a NACK
+ *
+ *  The first transmission keeps the Nonce of \p interest, if it has one;
+ *  each retransmission carries a new Nonce.
  */
 void
 requestAutoRetry(ClientFace& face, const Interest& interest,
                  const OnData& onData, const OnTimeout& onFail = nullptr,
                  const AutoRetryDecision& retryDecision = AutoRetryForever(),
                  const time::milliseconds& retxInterval = time::milliseconds::min(),
-                 const time::milliseconds& nackRetxDelay = time::milliseconds(200));
+                 const NackBackoff& nackBackoff = NackBackoffFixed(time::milliseconds(200)));
 
 } // namespace util
 } // namespace ndn
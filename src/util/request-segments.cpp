@@ -1,4 +1,5 @@
 #include "request-segments.hpp"
+#include <map>
 
 namespace ndn {
 namespace util {
@@ -11,42 +12,78 @@ public:
                   const std::function<void()>& onSuccess, const OnTimeout& onFail,
                   const AutoRetryDecision& retryDecision,
                   const time::milliseconds& retxInterval,
-                  const EditInterest& editInterest);
+                  const EditInterest& editInterest,
+                  const SegmentPipeline& pipeline);
 
 private:
   void
   sendVersionDiscoveryInterest();
 
   void
-  handleVersionDiscoveryData(Data& data);
+  handleVersionDiscoveryData(const Interest& interest, Data& data);
 
+  /** \brief sends Interests for segments within the window
+   */
   void
-  sendInterest();
+  fillWindow();
 
   void
-  handleData(Data& data);
+  sendInterest(uint64_t segment);
 
   void
-  handleFail();
+  handleData(uint64_t segment, const Interest& interest, Data& data);
 
-public:
-  /** \brief retains a self pointer, to be deleted after onSuccess or onFail
+  /** \brief buffers a segment, and delivers buffered segments in order
    */
-  unique_ptr<RequestSegments> self;
+  void
+  acceptData(uint64_t segment, const Interest& interest, Data& data);
+
+  /** \brief handles failure of the request for \p segment
+   *
+   *  Failure of a segment beyond FinalBlockId is ignored: it was requested speculatively
+   *  before the last segment is known, and does not exist.
+   */
+  void
+  handleFail(uint64_t segment, const Interest& interest);
+
+  void
+  fail(const Interest& interest);
+
+  /** \brief invokes retryDecision, and shrinks the window upon congestion signal
+   *
+   *  A segment beyond FinalBlockId is not retried, and does not shrink the window.
+   */
+  bool
+  decideRetry(uint64_t segment, int nSent, bool isTimeout, NackCode nackCode);
+
+  /** \brief deletes this after the last outstanding request completes
+   *
+   *  Requests for other segments can be outstanding upon success or failure;
+   *  they are not retried, but this must live until they complete.
+   */
+  void
+  deleteIfDone();
 
 private:
   ClientFace& m_face;
   Name m_baseName;
   Name m_versionedName;
-  std::pair<uint64_t, uint64_t> m_segmentRange;
-  uint64_t m_currentSegment;
-  Interest m_interest;
+  uint64_t m_lastSegment;
+  uint64_t m_nextSegment; ///< next segment to request
+  uint64_t m_nextDeliver; ///< next segment to deliver
+  std::map<uint64_t, std::pair<Interest, Data>> m_outOfOrder;
+  size_t m_nOutstanding;
+  bool m_isFinished;
   OnData m_onData;
   std::function<void()> m_onSuccess;
   OnTimeout m_onFail;
   AutoRetryDecision m_retryDecision;
   time::milliseconds m_retxInterval;
   EditInterest m_editInterest;
+
+  SegmentPipeline m_pipeline;
+  double m_window;
+  uint64_t m_recoverySegment; ///< window is not shrunk again for segments before this
 };
 
 
@@ -55,17 +92,24 @@ RequestSegments::RequestSegments(ClientFace& face, const Name& baseName,
                                  const std::function<void()>& onSuccess, const OnTimeout& onFail,
                                  const AutoRetryDecision& retryDecision,
                                  const time::milliseconds& retxInterval,
-                                 const EditInterest& editInterest)
+                                 const EditInterest& editInterest,
+                                 const SegmentPipeline& pipeline)
   : m_face(face)
   , m_baseName(baseName)
-  , m_segmentRange(segmentRange)
-  , m_currentSegment(segmentRange.first)
+  , m_lastSegment(segmentRange.second)
+  , m_nextSegment(segmentRange.first)
+  , m_nextDeliver(segmentRange.first)
+  , m_nOutstanding(0)
+  , m_isFinished(false)
   , m_onData(onData)
   , m_onSuccess(onSuccess)
   , m_onFail(onFail)
   , m_retryDecision(retryDecision)
   , m_retxInterval(retxInterval)
   , m_editInterest(editInterest)
+  , m_pipeline(pipeline)
+  , m_window(std::max(pipeline.initialWindow, 1.0))
+  , m_recoverySegment(segmentRange.first)
 {
   if (!static_cast<bool>(m_onData))
     m_onData = bind([]{});
@@ -79,7 +123,7 @@ RequestSegments::RequestSegments(ClientFace& face, const Name& baseName,
   bool hasKnownVersion = baseName.size() >= 1 && baseName.at(-1).isVersion();
   if (hasKnownVersion) {
     m_versionedName = baseName;
-    this->sendInterest();
+    this->fillWindow();
   }
   else {
     this->sendVersionDiscoveryInterest();
@@ -89,71 +133,169 @@ RequestSegments::RequestSegments(ClientFace& face, const Name& baseName,
 void
 RequestSegments::sendVersionDiscoveryInterest()
 {
-  m_interest = Interest(m_baseName);
-  m_interest.setChildSelector(1);
+  Interest interest(m_baseName);
+  interest.setChildSelector(1);
 
-  requestAutoRetry(m_face, m_interest,
-                   bind(&RequestSegments::handleVersionDiscoveryData, this, _2),
-                   bind(&RequestSegments::handleFail, this),
-                   m_retryDecision, m_retxInterval);
+  // callbacks capture only this and segment, so that std::function stores them inline
+  uint64_t segment = m_nextSegment;
+  ++m_nOutstanding;
+  requestAutoRetry(m_face, interest,
+                   [this] (const Interest& interest, Data& data) {
+                     this->handleVersionDiscoveryData(interest, data);
+                   },
+                   [this, segment] (const Interest& interest) {
+                     this->handleFail(segment, interest);
+                   },
+                   [this, segment] (int nSent, bool isTimeout, NackCode nackCode) {
+                     return this->decideRetry(segment, nSent, isTimeout, nackCode);
+                   },
+                   m_retxInterval);
 }
 
 void
-RequestSegments::handleVersionDiscoveryData(Data& data)
+RequestSegments::handleVersionDiscoveryData(const Interest& interest, Data& data)
 {
+  --m_nOutstanding;
+  if (m_isFinished) {
+    this->deleteIfDone();
+    return;
+  }
+
   const Name& dataName = data.getName();
   bool hasSegment = dataName.size() >= 1 && dataName.at(-1).isSegment();
   if (!hasSegment) {
-    this->handleFail();
+    this->fail(interest);
+    this->deleteIfDone();
     return;
   }
 
   m_versionedName = dataName.getPrefix(-1); // unversioned Names are permitted
 
-  if (dataName.at(-1).toSegment() == m_segmentRange.first) {
-    this->handleData(data);
+  if (dataName.at(-1).toSegment() == m_nextSegment) {
+    ++m_nextSegment;
+    this->acceptData(dataName.at(-1).toSegment(), interest, data);
   }
-  else {
-    this->sendInterest();
+  this->fillWindow();
+  this->deleteIfDone();
+}
+
+void
+RequestSegments::fillWindow()
+{
+  while (!m_isFinished && m_nextSegment <= m_lastSegment &&
+         m_nextSegment - m_nextDeliver < static_cast<uint64_t>(m_window)) {
+    this->sendInterest(m_nextSegment++);
   }
 }
 
 void
-RequestSegments::sendInterest()
+RequestSegments::sendInterest(uint64_t segment)
 {
-  m_interest = Interest(Name(m_versionedName).appendSegment(m_currentSegment));
-  m_editInterest(m_interest);
+  Interest interest(Name(m_versionedName).appendSegment(segment));
+  m_editInterest(interest);
 
-  requestAutoRetry(m_face, m_interest,
-                   bind(&RequestSegments::handleData, this, _2),
-                   bind(&RequestSegments::handleFail, this),
-                   m_retryDecision, m_retxInterval);
+  ++m_nOutstanding;
+  requestAutoRetry(m_face, interest,
+                   [this, segment] (const Interest& interest, Data& data) {
+                     this->handleData(segment, interest, data);
+                   },
+                   [this, segment] (const Interest& interest) {
+                     this->handleFail(segment, interest);
+                   },
+                   [this, segment] (int nSent, bool isTimeout, NackCode nackCode) {
+                     return this->decideRetry(segment, nSent, isTimeout, nackCode);
+                   },
+                   m_retxInterval);
 }
 
 void
-RequestSegments::handleData(Data& data)
+RequestSegments::handleData(uint64_t segment, const Interest& interest, Data& data)
 {
-  BOOST_ASSERT(data.getName().size() == m_versionedName.size() + 1);
-  const name::Component& segmentComponent = data.getName().at(-1);
-  BOOST_ASSERT(segmentComponent.toSegment() == m_currentSegment);
+  --m_nOutstanding;
+  if (!m_isFinished) {
+    BOOST_ASSERT(data.getName().size() == m_versionedName.size() + 1);
+    BOOST_ASSERT(data.getName().at(-1).toSegment() == segment);
 
-  m_onData(m_interest, data);
+    if (m_pipeline.isAdaptive) {
+      m_window = std::min(m_window + 1.0 / m_window, m_pipeline.maxWindow);
+    }
+    this->acceptData(segment, interest, data);
+    this->fillWindow();
+  }
+  this->deleteIfDone();
+}
 
-  if (m_currentSegment == m_segmentRange.second ||
-      data.getFinalBlockId() == segmentComponent) {
-    m_onSuccess();
-    self.reset();
+void
+RequestSegments::acceptData(uint64_t segment, const Interest& interest, Data& data)
+{
+  const name::Component& finalBlockId = data.getFinalBlockId();
+  if (finalBlockId.isSegment()) {
+    m_lastSegment = std::min(m_lastSegment, finalBlockId.toSegment());
+  }
+
+  if (segment != m_nextDeliver) {
+    if (segment <= m_lastSegment) {
+      m_outOfOrder.insert({segment, {interest, data}});
+    }
     return;
   }
-  ++m_currentSegment;
-  this->sendInterest();
+
+  m_onData(interest, data);
+  ++m_nextDeliver;
+
+  for (auto it = m_outOfOrder.begin();
+       it != m_outOfOrder.end() && it->first == m_nextDeliver && m_nextDeliver <= m_lastSegment;
+       it = m_outOfOrder.erase(it)) {
+    m_onData(it->second.first, it->second.second);
+    ++m_nextDeliver;
+  }
+
+  if (m_nextDeliver > m_lastSegment) {
+    m_isFinished = true;
+    m_outOfOrder.clear();
+    m_onSuccess();
+  }
 }
 
 void
-RequestSegments::handleFail()
+RequestSegments::handleFail(uint64_t segment, const Interest& interest)
 {
-  m_onFail(m_interest);
-  self.reset();
+  --m_nOutstanding;
+  if (!m_isFinished && segment <= m_lastSegment) {
+    this->fail(interest);
+  }
+  this->deleteIfDone();
+}
+
+void
+RequestSegments::fail(const Interest& interest)
+{
+  m_isFinished = true;
+  m_outOfOrder.clear();
+  m_onFail(interest);
+}
+
+bool
+RequestSegments::decideRetry(uint64_t segment, int nSent, bool isTimeout, NackCode nackCode)
+{
+  if (m_isFinished || segment > m_lastSegment) {
+    return false;
+  }
+
+  bool isCongestion = isTimeout || nackCode == Nack::BUSY;
+  if (m_pipeline.isAdaptive && isCongestion && segment >= m_recoverySegment) {
+    m_window = std::max(m_window / 2.0, std::max(m_pipeline.minWindow, 1.0));
+    m_recoverySegment = m_nextSegment;
+  }
+  return m_retryDecision(nSent, isTimeout, nackCode);
+}
+
+void
+RequestSegments::deleteIfDone()
+{
+  if (m_isFinished && m_nOutstanding == 0) {
+    m_face.getRequestPool().destroy(this);
+  }
 }
 
 void
@@ -162,12 +304,14 @@ requestSegments(ClientFace& face, const Name& baseName,
                 const std::function<void()>& onSuccess, const OnTimeout& onFail,
                 const AutoRetryDecision& retryDecision,
                 const time::milliseconds& retxInterval,
-                const EditInterest& editInterest)
+                const EditInterest& editInterest,
+                const SegmentPipeline& pipeline)
 {
-  auto rs = new RequestSegments(face, baseName, segmentRange,
-                                onData, onSuccess, onFail,
-                                retryDecision, retxInterval, editInterest);
-  rs->self.reset(rs);
+  // deleted after onSuccess or onFail, and all outstanding requests complete
+  face.getRequestPool().construct<RequestSegments>(face, baseName, segmentRange,
+                                                   onData, onSuccess, onFail,
+                                                   retryDecision, retxInterval, editInterest,
+                                                   pipeline);
 }
 
 } // namespace util
@@ -8,14 +8,68 @@ namespace util {
 
 typedef std::function<void(Interest&)> EditInterest;
 
+/** \brief window control of requestSegments
+ *
+ *  Segments from the first segment not yet delivered, up to window segments,
+ *  are requested at the same time.
+ *  If adaptive, the window grows by one segment after a window of Data (additive increase),
+ *  and is halved upon a timeout or Nack-BUSY (multiplicative decrease),
+ *  at most once per window.
+ */
+class SegmentPipeline
+{
+public:
+  /** \brief stop-and-wait: next segment is requested after previous segment arrives
+   */
+  SegmentPipeline()
+    : initialWindow(1)
+    , minWindow(1)
+    , maxWindow(1)
+    , isAdaptive(false)
+  {
+  }
+
+public:
+  double initialWindow;
+  double minWindow;
+  double maxWindow;
+  bool isAdaptive;
+};
+
+class SegmentPipelineFixed : public SegmentPipeline
+{
+public:
+  explicit
+  SegmentPipelineFixed(size_t window)
+  {
+    initialWindow = minWindow = maxWindow = window;
+  }
+};
+
+class SegmentPipelineAimd : public SegmentPipeline
+{
+public:
+  explicit
+  SegmentPipelineAimd(double initial = 2, double max = 64)
+  {
+    initialWindow = initial;
+    maxWindow = max;
+    isAdaptive = true;
+  }
+};
+
 /** \brief send Interests to request segments
  *  \param baseName prefix of the segments;
  *                  if last component has no version marker, first Interest will have
  *                  ChildSelector=rightmost, and first segment will be requested again
  *  \param segmentRange segment number of first and last segment;
  *                      FinalBlockId will be honored
- *  \param onData invoked upon each Data arrival
+ *  \param onData invoked upon each Data arrival, in order of segment number
+ *  \param retryDecision retransmission decision for each segment
+ *  \param retxInterval timeout of each transmission, or AUTO_RETRY_ADAPTIVE
  *  \param editInterest a hook for editing the Interest before it's sent
+ *  \param pipeline window control; Interests for segments beyond FinalBlockId
+ *                  may be sent before FinalBlockId is known
  */
 void
 requestSegments(ClientFace& face, const Name& baseName,
@@ -25,7 +79,8 @@ requestSegments(ClientFace& face, const Name& baseName,
                 const OnTimeout& onFail = nullptr,
                 const AutoRetryDecision& retryDecision = AutoRetryForever(),
                 const time::milliseconds& retxInterval = time::milliseconds::min(),
-                const EditInterest& editInterest = nullptr);
+                const EditInterest& editInterest = nullptr,
+                const SegmentPipeline& pipeline = SegmentPipeline());
 
 } // namespace util
 } // namespace ndn
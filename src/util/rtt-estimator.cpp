@@ -0,0 +1,46 @@
+#include "rtt-estimator.hpp"
+#include <algorithm>
+
+namespace ndn {
+namespace util {
+
+RttEstimator::RttEstimator()
+  : initialRto(time::seconds(1))
+  , minRto(time::milliseconds(200))
+  , maxRto(time::seconds(60))
+  , m_srtt(time::nanoseconds::zero())
+  , m_rttVar(time::nanoseconds::zero())
+  , m_rto(time::nanoseconds::zero())
+  , m_nMeasurements(0)
+{
+}
+
+void
+RttEstimator::addMeasurement(const time::nanoseconds& rtt)
+{
+  if (m_nMeasurements == 0) {
+    m_srtt = rtt;
+    m_rttVar = rtt / 2;
+  }
+  else {
+    time::nanoseconds delta = m_srtt > rtt ? m_srtt - rtt : rtt - m_srtt;
+    m_rttVar = (m_rttVar * 3 + delta) / 4;
+    m_srtt = (m_srtt * 7 + rtt) / 8;
+  }
+  ++m_nMeasurements;
+
+  m_rto = std::min(std::max(m_srtt + m_rttVar * 4, minRto), maxRto);
+}
+
+time::nanoseconds
+RttEstimator::getBackoffRto(int nSent) const
+{
+  time::nanoseconds rto = this->getRto();
+  for (int i = 1; i < nSent && rto < maxRto; ++i) {
+    rto *= 2;
+  }
+  return std::min(rto, maxRto);
+}
+
+} // namespace util
+} // namespace ndn
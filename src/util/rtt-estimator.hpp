@@ -0,0 +1,93 @@
+#ifndef NDNCXXEXT_UTIL_RTT_ESTIMATOR_HPP
+#define NDNCXXEXT_UTIL_RTT_ESTIMATOR_HPP
+
+#include "common.hpp"
+
+namespace ndn {
+namespace util {
+
+/** \brief round-trip time estimator, computing retransmission timeout as in RFC 6298
+ *
+ *  Before the first measurement, RTO is initialRto.
+ *  The first measurement R sets SRTT=R and RTTVAR=R/2. A later measurement R updates
+ *  RTTVAR=(1-beta)*RTTVAR+beta*|SRTT-R| and SRTT=(1-alpha)*SRTT+alpha*R,
+ *  with alpha=1/8 and beta=1/4. RTO=SRTT+4*RTTVAR, bounded by minRto and maxRto.
+ *
+ *  The caller is responsible for Karn's rule: a response to a retransmitted request
+ *  must not be measured, because it could be a response to an earlier transmission.
+ */
+class RttEstimator
+{
+public:
+  RttEstimator();
+
+  /** \brief adds an RTT measurement
+   */
+  void
+  addMeasurement(const time::nanoseconds& rtt);
+
+  /** \return retransmission timeout
+   */
+  time::nanoseconds
+  getRto() const
+  {
+    return m_nMeasurements > 0 ? m_rto : initialRto;
+  }
+
+  /** \return retransmission timeout for \p nSent th transmission of a request
+   *
+   *  RTO is doubled for each retransmission, up to maxRto.
+   */
+  time::nanoseconds
+  getBackoffRto(int nSent) const;
+
+  bool
+  hasMeasurement() const
+  {
+    return m_nMeasurements > 0;
+  }
+
+  uint64_t
+  getNMeasurements() const
+  {
+    return m_nMeasurements;
+  }
+
+  time::nanoseconds
+  getSrtt() const
+  {
+    return m_srtt;
+  }
+
+  time::nanoseconds
+  getRttVar() const
+  {
+    return m_rttVar;
+  }
+
+public:
+  /** \brief RTO before the first measurement
+   */
+  time::nanoseconds initialRto;
+
+  /** \brief lower bound of RTO
+   *
+   *  RFC 6298 recommends one second; a smaller default suits datacenter and LAN RTTs.
+   */
+  time::nanoseconds minRto;
+
+  /** \brief upper bound of RTO, including backoff
+   */
+  time::nanoseconds maxRto;
+
+private:
+  time::nanoseconds m_srtt;
+  time::nanoseconds m_rttVar;
+  time::nanoseconds m_rto;
+  uint64_t m_nMeasurements;
+};
+
+} // namespace util
+} // namespace ndn
+
+#endif // NDNCXXEXT_UTIL_RTT_ESTIMATOR_HPP
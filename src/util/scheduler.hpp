@@ -17,6 +17,11 @@ typedef shared_ptr<SchedulerEventIdBase> SchedulerEventId;
 class SchedulerBase : noncopyable
 {
 public:
+  virtual
+  ~SchedulerBase()
+  {
+  }
+
   virtual SchedulerEventId
   schedule(const time::nanoseconds& after, const scheduler::Scheduler::Event& f) = 0;
 
@@ -0,0 +1,437 @@
+#include "timing-wheel-scheduler.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace ndn {
+namespace util {
+
+const int TimingWheelScheduler::SLOT_BITS;
+const size_t TimingWheelScheduler::N_SLOTS;
+const uint64_t TimingWheelScheduler::SLOT_MASK;
+const int TimingWheelScheduler::N_LEVELS;
+const size_t TimingWheelScheduler::ALLOC_CHUNK;
+
+static const uint64_t UNARMED = std::numeric_limits<uint64_t>::max();
+
+class TimingWheelScheduler::TimerPool : ndn::noncopyable
+{
+public:
+  TimerPool()
+    : m_blockSize(0)
+  {
+  }
+
+  ~TimerPool()
+  {
+    // every control block has been returned, because an EventId keeps the pool alive
+    for (void* block : m_freeBlocks) {
+      ::operator delete(block);
+    }
+  }
+
+  Timer*
+  allocateTimer()
+  {
+    if (m_freeTimers.empty()) {
+      m_chunks.emplace_back(new Timer[ALLOC_CHUNK]);
+      Timer* chunk = m_chunks.back().get();
+      m_freeTimers.reserve(m_chunks.size() * ALLOC_CHUNK);
+      for (size_t i = 0; i < ALLOC_CHUNK; ++i) {
+        chunk[i].slot = nullptr;
+        m_freeTimers.push_back(&chunk[i]);
+      }
+    }
+
+    Timer* timer = m_freeTimers.back();
+    m_freeTimers.pop_back();
+    timer->isFinished = false;
+    timer->hasHandle = true;
+    return timer;
+  }
+
+  void
+  recycle(Timer* timer)
+  {
+    BOOST_ASSERT(timer->isFinished && !timer->hasHandle);
+    m_freeTimers.push_back(timer);
+  }
+
+  size_t
+  getCapacity() const
+  {
+    return m_chunks.size() * ALLOC_CHUNK;
+  }
+
+  /** \brief allocates an EventId control block
+   *
+   *  All control blocks have the same size, which is learned from the first request.
+   */
+  void*
+  allocateBlock(size_t size)
+  {
+    if (m_blockSize == 0) {
+      m_blockSize = size;
+    }
+    if (size != m_blockSize) {
+      return ::operator new(size);
+    }
+    if (m_freeBlocks.empty()) {
+      return ::operator new(size);
+    }
+    void* block = m_freeBlocks.back();
+    m_freeBlocks.pop_back();
+    return block;
+  }
+
+  void
+  deallocateBlock(void* block, size_t size)
+  {
+    if (size != m_blockSize) {
+      ::operator delete(block);
+      return;
+    }
+    m_freeBlocks.push_back(block);
+  }
+
+private:
+  std::vector<unique_ptr<Timer[]>> m_chunks;
+  std::vector<Timer*> m_freeTimers;
+  size_t m_blockSize;
+  std::vector<void*> m_freeBlocks;
+};
+
+/** \brief allocates EventId control blocks from TimerPool
+ *
+ *  It holds a reference to the pool, so that the pool outlives the last control block.
+ */
+template<typename T>
+class TimingWheelScheduler::HandleAllocator
+{
+public:
+  typedef T value_type;
+
+  explicit
+  HandleAllocator(const shared_ptr<TimerPool>& pool)
+    : pool(pool)
+  {
+  }
+
+  template<typename U>
+  HandleAllocator(const HandleAllocator<U>& other)
+    : pool(other.pool)
+  {
+  }
+
+  T*
+  allocate(size_t n)
+  {
+    return static_cast<T*>(pool->allocateBlock(n * sizeof(T)));
+  }
+
+  void
+  deallocate(T* p, size_t n)
+  {
+    pool->deallocateBlock(p, n * sizeof(T));
+  }
+
+  template<typename U>
+  bool
+  operator==(const HandleAllocator<U>& other) const
+  {
+    return pool == other.pool;
+  }
+
+  template<typename U>
+  bool
+  operator!=(const HandleAllocator<U>& other) const
+  {
+    return pool != other.pool;
+  }
+
+public:
+  shared_ptr<TimerPool> pool;
+};
+
+/** \brief invoked when the last EventId of a timer is released
+ */
+class TimingWheelScheduler::HandleDeleter
+{
+public:
+  explicit
+  HandleDeleter(TimerPool* pool)
+    : m_pool(pool)
+  {
+  }
+
+  void
+  operator()(Timer* timer) const
+  {
+    timer->hasHandle = false;
+    if (timer->isFinished) {
+      m_pool->recycle(timer);
+    }
+  }
+
+private:
+  TimerPool* m_pool;
+};
+
+TimingWheelScheduler::TimingWheelScheduler(boost::asio::io_service& io,
+                                           const time::nanoseconds& tickDuration)
+  : m_deadline(io)
+  , m_tickDuration(tickDuration)
+  , m_epoch(time::steady_clock::now())
+  , m_currentTick(0)
+  , m_armedTick(UNARMED)
+  , m_nScheduled(0)
+  , m_nLevel0(0)
+  , m_pool(make_shared<TimerPool>())
+{
+  BOOST_ASSERT(m_tickDuration > time::nanoseconds::zero());
+  for (int level = 0; level < N_LEVELS; ++level) {
+    for (size_t i = 0; i < N_SLOTS; ++i) {
+      m_wheel[level][i].head = nullptr;
+    }
+  }
+}
+
+TimingWheelScheduler::~TimingWheelScheduler()
+{
+  m_deadline.cancel();
+}
+
+size_t
+TimingWheelScheduler::getCapacity() const
+{
+  return m_pool->getCapacity();
+}
+
+uint64_t
+TimingWheelScheduler::getTick(const time::steady_clock::TimePoint& t) const
+{
+  if (t <= m_epoch) {
+    return 0;
+  }
+  return time::duration_cast<time::nanoseconds>(t - m_epoch).count() / m_tickDuration.count();
+}
+
+SchedulerEventId
+TimingWheelScheduler::schedule(const time::nanoseconds& after,
+                               const scheduler::Scheduler::Event& f)
+{
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  if (m_nScheduled == 0) {
+    // wheel is empty, no need to walk through idle ticks
+    m_currentTick = std::max(m_currentTick, this->getTick(now));
+  }
+
+  // round up, so that the event does not fire earlier than requested
+  time::steady_clock::TimePoint t = now + after + m_tickDuration;
+
+  Timer* timer = this->allocateTimer();
+  timer->expiry = std::max(this->getTick(t), m_currentTick);
+  timer->callback = f;
+  this->link(timer);
+  ++m_nScheduled;
+
+  if (this->getNextWakeTick() < m_armedTick) {
+    this->arm();
+  }
+  return SchedulerEventId(timer, HandleDeleter(m_pool.get()), HandleAllocator<Timer>(m_pool));
+}
+
+void
+TimingWheelScheduler::cancel(const SchedulerEventId& id)
+{
+  if (id == nullptr) {
+    return;
+  }
+  // a Timer cannot be recycled while an EventId refers to it,
+  // so id either is scheduled or has fired or been cancelled
+  Timer* timer = static_cast<Timer*>(id.get());
+  if (timer->isFinished) {
+    return;
+  }
+  this->unlink(timer);
+  --m_nScheduled;
+  timer->callback = nullptr;
+  this->finishTimer(timer);
+  // deadline is left armed; it's harmless to wake up once without any work
+}
+
+TimingWheelScheduler::Timer*
+TimingWheelScheduler::allocateTimer()
+{
+  return m_pool->allocateTimer();
+}
+
+void
+TimingWheelScheduler::finishTimer(Timer* timer)
+{
+  BOOST_ASSERT(timer->slot == nullptr);
+  timer->isFinished = true;
+  if (!timer->hasHandle) {
+    m_pool->recycle(timer);
+  }
+}
+
+void
+TimingWheelScheduler::link(Timer* timer)
+{
+  uint64_t delta = timer->expiry - m_currentTick;
+  int level = 0;
+  while (level < N_LEVELS - 1 &&
+         delta >= (static_cast<uint64_t>(1) << ((level + 1) * SLOT_BITS))) {
+    ++level;
+  }
+
+  uint64_t expiry = timer->expiry;
+  static const uint64_t MAX_DELTA = (static_cast<uint64_t>(1) << (N_LEVELS * SLOT_BITS)) - 1;
+  if (delta > MAX_DELTA) {
+    // beyond the wheel; it will be re-linked when cascaded
+    expiry = m_currentTick + MAX_DELTA;
+  }
+
+  Slot* slot = &m_wheel[level][(expiry >> (level * SLOT_BITS)) & SLOT_MASK];
+  timer->slot = slot;
+  timer->prev = nullptr;
+  timer->next = slot->head;
+  if (slot->head != nullptr) {
+    slot->head->prev = timer;
+  }
+  slot->head = timer;
+
+  if (level == 0) {
+    ++m_nLevel0;
+  }
+}
+
+void
+TimingWheelScheduler::unlink(Timer* timer)
+{
+  BOOST_ASSERT(timer->slot != nullptr);
+  if (timer->prev != nullptr) {
+    timer->prev->next = timer->next;
+  }
+  else {
+    timer->slot->head = timer->next;
+  }
+  if (timer->next != nullptr) {
+    timer->next->prev = timer->prev;
+  }
+
+  if (timer->slot >= &m_wheel[0][0] && timer->slot < &m_wheel[0][0] + N_SLOTS) {
+    --m_nLevel0;
+  }
+  timer->slot = nullptr;
+}
+
+void
+TimingWheelScheduler::cascade(int level)
+{
+  Slot& slot = m_wheel[level][(m_currentTick >> (level * SLOT_BITS)) & SLOT_MASK];
+  Timer* timer = slot.head;
+  slot.head = nullptr;
+  while (timer != nullptr) {
+    Timer* next = timer->next;
+    timer->slot = nullptr;
+    this->link(timer);
+    timer = next;
+  }
+}
+
+void
+TimingWheelScheduler::processTick()
+{
+  for (int level = 1; level < N_LEVELS; ++level) {
+    if (((m_currentTick >> ((level - 1) * SLOT_BITS)) & SLOT_MASK) != 0) {
+      break;
+    }
+    this->cascade(level);
+  }
+
+  // detach expired timers, because a callback may schedule an event into the same slot;
+  // they remain cancellable in the detached list
+  Slot expired;
+  Slot& slot = m_wheel[0][m_currentTick & SLOT_MASK];
+  expired.head = slot.head;
+  slot.head = nullptr;
+  for (Timer* timer = expired.head; timer != nullptr; timer = timer->next) {
+    BOOST_ASSERT(timer->expiry == m_currentTick);
+    timer->slot = &expired;
+    --m_nLevel0;
+  }
+  ++m_currentTick;
+
+  while (expired.head != nullptr) {
+    Timer* timer = expired.head;
+    this->unlink(timer);
+    --m_nScheduled;
+    scheduler::Scheduler::Event callback;
+    callback.swap(timer->callback);
+    this->finishTimer(timer);
+    callback();
+  }
+}
+
+void
+TimingWheelScheduler::advance(uint64_t targetTick)
+{
+  while (m_currentTick <= targetTick) {
+    if (m_nLevel0 == 0 && (m_currentTick & SLOT_MASK) != 0) {
+      // skip ticks until next cascade
+      uint64_t boundary = (m_currentTick | SLOT_MASK) + 1;
+      if (boundary > targetTick) {
+        m_currentTick = targetTick + 1;
+        return;
+      }
+      m_currentTick = boundary;
+      continue;
+    }
+    this->processTick();
+  }
+}
+
+uint64_t
+TimingWheelScheduler::getNextWakeTick() const
+{
+  if (m_nScheduled == 0) {
+    return UNARMED;
+  }
+  if (m_nLevel0 == 0 && (m_currentTick & SLOT_MASK) != 0) {
+    return (m_currentTick | SLOT_MASK) + 1;
+  }
+  for (uint64_t tick = m_currentTick; m_nLevel0 > 0; ++tick) {
+    if (m_wheel[0][tick & SLOT_MASK].head != nullptr || (tick & SLOT_MASK) == 0) {
+      return tick;
+    }
+  }
+  return m_currentTick;
+}
+
+void
+TimingWheelScheduler::arm()
+{
+  m_armedTick = this->getNextWakeTick();
+  if (m_armedTick == UNARMED) {
+    m_deadline.cancel();
+    return;
+  }
+  m_deadline.expires_at(m_epoch + m_tickDuration * static_cast<int64_t>(m_armedTick));
+  m_deadline.async_wait(bind(&TimingWheelScheduler::onDeadline, this, _1));
+}
+
+void
+TimingWheelScheduler::onDeadline(const boost::system::error_code& ec)
+{
+  if (ec == boost::asio::error::operation_aborted) {
+    return;
+  }
+
+  m_armedTick = UNARMED;
+  this->advance(this->getTick(time::steady_clock::now()));
+  this->arm();
+}
+
+} // namespace util
+} // namespace ndn
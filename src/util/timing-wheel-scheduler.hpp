@@ -0,0 +1,148 @@
+#ifndef NDNCXXEXT_UTIL_TIMING_WHEEL_SCHEDULER_HPP
+#define NDNCXXEXT_UTIL_TIMING_WHEEL_SCHEDULER_HPP
+
+#include "scheduler.hpp"
+#include <ndn-cxx/util/monotonic_deadline_timer.hpp>
+
+namespace ndn {
+namespace util {
+
+/** \brief SchedulerBase implemented with a hierarchical timing wheel
+ *
+ *  Time is divided into ticks. The wheel has N_LEVELS levels of N_SLOTS slots each;
+ *  a slot on level L covers N_SLOTS^L ticks, and its timers are cascaded to lower levels
+ *  when the current tick reaches that slot. Schedule and cancel are O(1).
+ *
+ *  Timers are kept in intrusive lists. A timer object is recycled onto a free list at the
+ *  moment both its event is finished (fired or cancelled) and its last SchedulerEventId is
+ *  released; the EventId's deleter does the latter. EventId control blocks come from
+ *  a free list as well, so that no heap allocation occurs in steady state.
+ *
+ *  A single deadline timer is armed for the next tick that needs processing.
+ *  Events fire on tick boundaries, up to one tick later than requested.
+ */
+class TimingWheelScheduler : public SchedulerBase
+{
+public:
+  explicit
+  TimingWheelScheduler(boost::asio::io_service& io,
+                       const time::nanoseconds& tickDuration = time::milliseconds(1));
+
+  virtual
+  ~TimingWheelScheduler();
+
+  virtual SchedulerEventId
+  schedule(const time::nanoseconds& after,
+           const scheduler::Scheduler::Event& f) NDNCXXEXT_DECL_OVERRIDE;
+
+  virtual void
+  cancel(const SchedulerEventId& id) NDNCXXEXT_DECL_OVERRIDE;
+
+  /** \return number of scheduled events
+   */
+  size_t
+  size() const
+  {
+    return m_nScheduled;
+  }
+
+  /** \return number of timer objects ever allocated
+   */
+  size_t
+  getCapacity() const;
+
+private:
+  struct Slot;
+
+  struct Timer : public SchedulerEventIdBase
+  {
+    Timer* prev;
+    Timer* next;
+    Slot* slot; ///< nullptr if not scheduled
+    uint64_t expiry;
+    scheduler::Scheduler::Event callback;
+    bool isFinished; ///< fired or cancelled
+    bool hasHandle; ///< referenced by a SchedulerEventId
+  };
+
+  /** \brief owns timer objects and EventId control blocks
+   *
+   *  It is shared with outstanding EventIds, so that an EventId can outlive the scheduler.
+   */
+  class TimerPool;
+
+  template<typename T>
+  class HandleAllocator;
+
+  class HandleDeleter;
+
+  struct Slot
+  {
+    Timer* head;
+  };
+
+  static const int SLOT_BITS = 8;
+  static const size_t N_SLOTS = 1 << SLOT_BITS;
+  static const uint64_t SLOT_MASK = N_SLOTS - 1;
+  static const int N_LEVELS = 4;
+  static const size_t ALLOC_CHUNK = 1024;
+
+  uint64_t
+  getTick(const time::steady_clock::TimePoint& t) const;
+
+  Timer*
+  allocateTimer();
+
+  /** \brief marks the event of \p timer as finished
+   */
+  void
+  finishTimer(Timer* timer);
+
+  void
+  link(Timer* timer);
+
+  void
+  unlink(Timer* timer);
+
+  /** \brief re-inserts timers in a higher level slot into lower levels
+   */
+  void
+  cascade(int level);
+
+  void
+  processTick();
+
+  /** \brief process all ticks up to and including \p targetTick
+   */
+  void
+  advance(uint64_t targetTick);
+
+  /** \return next tick that needs processing
+   */
+  uint64_t
+  getNextWakeTick() const;
+
+  void
+  arm();
+
+  void
+  onDeadline(const boost::system::error_code& ec);
+
+private:
+  monotonic_deadline_timer m_deadline;
+  time::nanoseconds m_tickDuration;
+  time::steady_clock::TimePoint m_epoch;
+  uint64_t m_currentTick; ///< next tick to be processed
+  uint64_t m_armedTick; ///< tick of armed deadline, or max if not armed
+
+  Slot m_wheel[N_LEVELS][N_SLOTS];
+  size_t m_nScheduled;
+  size_t m_nLevel0;
+
+  shared_ptr<TimerPool> m_pool;
+};
+
+} // namespace util
+} // namespace ndn
+
+#endif // NDNCXXEXT_UTIL_TIMING_WHEEL_SCHEDULER_HPP
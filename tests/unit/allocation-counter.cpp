@@ -0,0 +1,35 @@
+#include "allocation-counter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> g_nHeapAllocations(0);
+
+void*
+operator new(std::size_t size)
+{
+  ++g_nHeapAllocations;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+namespace ndn {
+namespace tests {
+
+size_t
+getNHeapAllocations()
+{
+  return g_nHeapAllocations;
+}
+
+} // namespace tests
+} // namespace ndn
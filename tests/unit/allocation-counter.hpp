@@ -0,0 +1,20 @@
+#ifndef NDNCXXEXT_TESTS_ALLOCATION_COUNTER_HPP
+#define NDNCXXEXT_TESTS_ALLOCATION_COUNTER_HPP
+
+#include "common.hpp"
+
+namespace ndn {
+namespace tests {
+
+/** \return number of invocations of global operator new in this process
+ *
+ *  The test binary replaces global operator new, so that a test can assert
+ *  how many heap allocations a piece of code makes.
+ */
+size_t
+getNHeapAllocations();
+
+} // namespace tests
+} // namespace ndn
+
+#endif // NDNCXXEXT_TESTS_ALLOCATION_COUNTER_HPP
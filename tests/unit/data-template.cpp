@@ -0,0 +1,48 @@
+#include "data-template.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestDataTemplate)
+
+BOOST_AUTO_TEST_CASE(Encode)
+{
+  static const uint8_t PAYLOAD[] = {0xBB, 0xBB, 0xBB, 0xBB};
+  Data prototype("ndn:/prototype");
+  prototype.setContent(PAYLOAD, sizeof(PAYLOAD));
+  prototype.setFreshnessPeriod(time::seconds(1));
+  DataTemplate dataTemplate(prototype);
+
+  Name name("ndn:/A/B");
+  Data data = dataTemplate.makeData(name);
+  BOOST_CHECK_EQUAL(data.getName(), name);
+  BOOST_CHECK_EQUAL(data.getFreshnessPeriod(), time::seconds(1));
+  BOOST_CHECK_EQUAL_COLLECTIONS(data.getContent().value_begin(), data.getContent().value_end(),
+                                PAYLOAD, PAYLOAD + sizeof(PAYLOAD));
+
+  // same encoding as a Data constructed with the Name
+  Data expected(name);
+  expected.setContent(PAYLOAD, sizeof(PAYLOAD));
+  expected.setFreshnessPeriod(time::seconds(1));
+  DataTemplate::addFakeSignature(expected);
+  const Block& expectedWire = expected.wireEncode();
+  BOOST_CHECK_EQUAL_COLLECTIONS(data.wireEncode().begin(), data.wireEncode().end(),
+                                expectedWire.begin(), expectedWire.end());
+
+  // header contains Data TLV-TYPE, TLV-LENGTH, and Name
+  Block header1 = dataTemplate.encodeHeader("ndn:/C");
+  Block header2 = dataTemplate.encodeHeader("ndn:/D/E");
+  BOOST_CHECK_EQUAL(header1.type(), tlv::Data);
+  BOOST_CHECK_EQUAL(header2.size(), header1.size() + 3);
+
+  // header buffer is sized to fit, not MAX_NDN_PACKET_SIZE
+  BOOST_CHECK_EQUAL(header1.getBuffer()->size(), header1.size());
+  BOOST_CHECK_EQUAL(header2.getBuffer()->size(), header2.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
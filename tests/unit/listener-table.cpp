@@ -0,0 +1,88 @@
+#include "listener-table.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestListenerTable)
+
+static OnInterest
+makeListener(int id, int& invoked)
+{
+  return [id, &invoked] (const Name&, const Interest&) { invoked = id; };
+}
+
+BOOST_AUTO_TEST_CASE(LongestPrefixMatch)
+{
+  int invoked = 0;
+  ListenerTable table;
+  BOOST_CHECK(table.insert("ndn:/A", makeListener(1, invoked)));
+  BOOST_CHECK(table.insert("ndn:/A/B/C", makeListener(3, invoked)));
+  BOOST_CHECK(table.insert("ndn:/A/B", makeListener(2, invoked)));
+  BOOST_CHECK_EQUAL(table.size(), 3);
+
+  shared_ptr<const ListenerTable::Listener> listener = table.findLongestPrefixMatch("ndn:/A/B/D");
+  BOOST_REQUIRE(listener != nullptr);
+  BOOST_CHECK_EQUAL(listener->prefix, Name("ndn:/A/B"));
+  listener->onInterest(listener->prefix, Interest("ndn:/A/B/D"));
+  BOOST_CHECK_EQUAL(invoked, 2);
+
+  listener = table.findLongestPrefixMatch("ndn:/A/B/C/D");
+  BOOST_REQUIRE(listener != nullptr);
+  BOOST_CHECK_EQUAL(listener->prefix, Name("ndn:/A/B/C"));
+
+  listener = table.findLongestPrefixMatch("ndn:/A");
+  BOOST_REQUIRE(listener != nullptr);
+  BOOST_CHECK_EQUAL(listener->prefix, Name("ndn:/A"));
+
+  BOOST_CHECK(table.findLongestPrefixMatch("ndn:/B") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Replace)
+{
+  int invoked = 0;
+  ListenerTable table;
+  BOOST_CHECK(table.insert("ndn:/A", makeListener(1, invoked)));
+  BOOST_CHECK(!table.insert("ndn:/A", makeListener(2, invoked)));
+  BOOST_CHECK_EQUAL(table.size(), 1);
+
+  shared_ptr<const ListenerTable::Listener> listener = table.findLongestPrefixMatch("ndn:/A/B");
+  BOOST_REQUIRE(listener != nullptr);
+  listener->onInterest(listener->prefix, Interest("ndn:/A/B"));
+  BOOST_CHECK_EQUAL(invoked, 2);
+
+  // a listener obtained earlier is not modified by replacement or erasure
+  BOOST_CHECK(!table.insert("ndn:/A", makeListener(3, invoked)));
+  BOOST_CHECK(table.erase("ndn:/A"));
+  listener->onInterest(listener->prefix, Interest("ndn:/A/B"));
+  BOOST_CHECK_EQUAL(invoked, 2);
+  BOOST_CHECK_EQUAL(listener->prefix, Name("ndn:/A"));
+}
+
+BOOST_AUTO_TEST_CASE(Erase)
+{
+  int invoked = 0;
+  ListenerTable table;
+  table.insert("ndn:/", makeListener(0, invoked));
+  table.insert("ndn:/A/B/C", makeListener(3, invoked));
+  table.insert("ndn:/A", makeListener(1, invoked));
+
+  BOOST_CHECK(!table.erase("ndn:/A/B"));
+  BOOST_CHECK(table.erase("ndn:/A/B/C"));
+  BOOST_CHECK(!table.erase("ndn:/A/B/C"));
+  BOOST_CHECK_EQUAL(table.size(), 2);
+  BOOST_CHECK_EQUAL(table.findLongestPrefixMatch("ndn:/A/B/C")->prefix, Name("ndn:/A"));
+
+  BOOST_CHECK(table.erase("ndn:/A"));
+  BOOST_CHECK_EQUAL(table.findLongestPrefixMatch("ndn:/A/B/C")->prefix, Name("ndn:/"));
+
+  BOOST_CHECK(table.erase("ndn:/"));
+  BOOST_CHECK(table.findLongestPrefixMatch("ndn:/A/B/C") == nullptr);
+  BOOST_CHECK_EQUAL(table.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
@@ -1,4 +1,5 @@
 #include "nack.hpp"
+#include <ndn-cxx/encoding/block-helpers.hpp>
 
 #include "boost-test.hpp"
 
@@ -46,6 +47,103 @@ BOOST_AUTO_TEST_CASE(EncodeDecode2)
   BOOST_CHECK_EQUAL(interest2.getNonce(), 0x5555);
 }
 
+BOOST_AUTO_TEST_CASE(LpEncodeDecode)
+{
+  Interest interest1("ndn:/A/1");
+  interest1.setMaxSuffixComponents(5);
+  interest1.setNonce(0x4444);
+
+  Nack nack1(Nack::BUSY, interest1);
+
+  Block header = nack1.encodeLpHeader();
+  const Block& payload = nack1.getInterest().wireEncode();
+  auto buffer = make_shared<Buffer>(header.wire(), header.size());
+  buffer->insert(buffer->end(), payload.wire(), payload.wire() + payload.size());
+  Block lpPacket(buffer);
+  BOOST_CHECK_EQUAL(lpPacket.type(), Nack::TLV_LP_PACKET);
+
+  Nack nack2;
+  BOOST_REQUIRE(nack2.decodeLp(lpPacket));
+  BOOST_CHECK_EQUAL(nack2.getCode(), Nack::BUSY);
+  BOOST_CHECK(nack2.getRetryAfter() == time::milliseconds::zero());
+
+  const Interest& interest2 = nack2.getInterest();
+  BOOST_CHECK_EQUAL(interest2.getName(), Name("ndn:/A/1"));
+  BOOST_CHECK_EQUAL(interest2.getMaxSuffixComponents(), 5);
+  BOOST_CHECK_EQUAL(interest2.getNonce(), 0x4444);
+
+  // an Interest is not an LpPacket
+  Nack nack3;
+  BOOST_CHECK(!nack3.decodeLp(interest1.wireEncode()));
+}
+
+BOOST_AUTO_TEST_CASE(LpReason)
+{
+  Interest interest1("ndn:/A/1");
+  interest1.setNonce(0x4444);
+  const Block& payload = interest1.wireEncode();
+
+  auto makeLpPacket = [&payload] (uint64_t reason) {
+    Block nackField(Nack::TLV_LP_NACK);
+    nackField.push_back(makeNonNegativeIntegerBlock(Nack::TLV_LP_NACK_REASON, reason));
+    Block lpPacket(Nack::TLV_LP_PACKET);
+    lpPacket.push_back(nackField);
+    lpPacket.push_back(Block(Nack::TLV_LP_FRAGMENT, payload));
+    lpPacket.encode();
+    return lpPacket;
+  };
+
+  // NackReason from an NDNLPv2 forwarder
+  Nack nack;
+  BOOST_REQUIRE(nack.decodeLp(makeLpPacket(50)));
+  BOOST_CHECK_EQUAL(nack.getCode(), Nack::BUSY);
+  BOOST_REQUIRE(nack.decodeLp(makeLpPacket(100)));
+  BOOST_CHECK_EQUAL(nack.getCode(), Nack::DUPLICATE);
+  BOOST_REQUIRE(nack.decodeLp(makeLpPacket(150)));
+  BOOST_CHECK_EQUAL(nack.getCode(), Nack::GIVEUP);
+  BOOST_REQUIRE(nack.decodeLp(makeLpPacket(9999)));
+  BOOST_CHECK_EQUAL(nack.getCode(), Nack::NONE);
+
+  // encoded NackReason is NDNLPv2 reason
+  Block header = Nack(Nack::BUSY, interest1).encodeLpHeader();
+  auto buffer = make_shared<Buffer>(header.wire(), header.size());
+  buffer->insert(buffer->end(), payload.wire(), payload.wire() + payload.size());
+  Block lpPacket(buffer);
+  lpPacket.parse();
+  const Block& nackField = lpPacket.get(Nack::TLV_LP_NACK);
+  nackField.parse();
+  BOOST_CHECK_EQUAL(readNonNegativeInteger(nackField.get(Nack::TLV_LP_NACK_REASON)),
+                    static_cast<uint64_t>(Nack::LP_NACK_REASON_CONGESTION));
+
+  for (NackCode code : {Nack::DUPLICATE, Nack::GIVEUP, Nack::NODATA}) {
+    Block header = Nack(code, interest1).encodeLpHeader();
+    auto buffer = make_shared<Buffer>(header.wire(), header.size());
+    buffer->insert(buffer->end(), payload.wire(), payload.wire() + payload.size());
+    BOOST_REQUIRE(nack.decodeLp(Block(buffer)));
+    BOOST_CHECK_EQUAL(nack.getCode(), code);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(LpRetryAfter)
+{
+  Interest interest1("ndn:/A/1");
+  interest1.setNonce(0x4444);
+
+  Nack nack1(Nack::BUSY, interest1);
+  nack1.setRetryAfter(time::milliseconds(1500));
+
+  Block header = nack1.encodeLpHeader();
+  const Block& payload = nack1.getInterest().wireEncode();
+  auto buffer = make_shared<Buffer>(header.wire(), header.size());
+  buffer->insert(buffer->end(), payload.wire(), payload.wire() + payload.size());
+
+  Nack nack2;
+  BOOST_REQUIRE(nack2.decodeLp(Block(buffer)));
+  BOOST_CHECK_EQUAL(nack2.getCode(), Nack::BUSY);
+  BOOST_CHECK(nack2.getRetryAfter() == time::milliseconds(1500));
+  BOOST_CHECK_EQUAL(nack2.getInterest().getName(), Name("ndn:/A/1"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
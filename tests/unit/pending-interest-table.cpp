@@ -0,0 +1,147 @@
+#include "pending-interest-table.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestPendingInterestTable)
+
+BOOST_AUTO_TEST_CASE(DataMatch)
+{
+  PendingInterestTable pit;
+  pit.insert(Interest("ndn:/A"));
+  pit.insert(Interest("ndn:/A/B"));
+  pit.insert(Interest("ndn:/A/B/C/D"));
+  pit.insert(Interest("ndn:/X"));
+  Interest i5("ndn:/A/B");
+  i5.setMaxSuffixComponents(1);
+  pit.insert(i5);
+  BOOST_CHECK_EQUAL(pit.size(), 5);
+
+  PendingInterestTable::EntryList satisfied;
+  pit.extractDataMatches(Data("ndn:/A/B/C"), satisfied);
+  BOOST_CHECK_EQUAL(satisfied.size(), 2);
+  BOOST_CHECK_EQUAL(pit.size(), 3);
+  for (auto&& entry : satisfied) {
+    BOOST_CHECK(entry.interest.getName().isPrefixOf("ndn:/A/B/C"));
+  }
+
+  satisfied.clear();
+  pit.extractDataMatches(Data("ndn:/A/B"), satisfied);
+  BOOST_CHECK_EQUAL(satisfied.size(), 1);
+  BOOST_CHECK_EQUAL(pit.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(NackMatch)
+{
+  PendingInterestTable pit;
+  Interest i1("ndn:/A/B");
+  i1.setNonce(1);
+  pit.insert(i1);
+  Interest i2("ndn:/A/B");
+  i2.setChildSelector(1);
+  pit.insert(i2);
+  pit.insert(Interest("ndn:/A"));
+
+  PendingInterestTable::EntryList satisfied;
+  pit.extractNackMatches(Interest("ndn:/A/B"), satisfied);
+  BOOST_CHECK_EQUAL(satisfied.size(), 1);
+  BOOST_CHECK_EQUAL(satisfied.front().interest.getNonce(), 1);
+  BOOST_CHECK_EQUAL(pit.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Fallback)
+{
+  PendingInterestTable pit;
+  // last component has the size of a digest
+  Name name("ndn:/A");
+  name.append(name::Component(std::string(32, 'D')));
+  pit.insert(Interest(name));
+  pit.insert(Interest("ndn:/A"));
+
+  PendingInterestTable::EntryList satisfied;
+  pit.extractNackMatches(Interest(name), satisfied);
+  BOOST_CHECK_EQUAL(satisfied.size(), 1);
+
+  pit.insert(Interest(name));
+  satisfied.clear();
+  pit.extractDataMatches(Data(name), satisfied);
+  BOOST_CHECK_EQUAL(satisfied.size(), 2);
+  BOOST_CHECK(pit.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Erase)
+{
+  PendingInterestTable pit;
+  auto it1 = pit.insert(Interest("ndn:/A"));
+  pit.insert(Interest("ndn:/A"));
+  pit.erase(it1);
+  BOOST_CHECK_EQUAL(pit.size(), 1);
+
+  PendingInterestTable::EntryList satisfied;
+  pit.extractDataMatches(Data("ndn:/A"), satisfied);
+  BOOST_CHECK_EQUAL(satisfied.size(), 1);
+  BOOST_CHECK(pit.empty());
+}
+
+BOOST_AUTO_TEST_CASE(FindSameInterest)
+{
+  PendingInterestTable pit;
+  pit.insert(Interest("ndn:/A"));
+  Interest i2("ndn:/A");
+  i2.setChildSelector(1);
+  auto it2 = pit.insert(i2);
+
+  BOOST_CHECK(pit.findSameInterest(i2) == &*it2);
+  BOOST_CHECK(pit.findSameInterest(Interest("ndn:/B")) == nullptr);
+
+  PendingInterestTable::EntryList extracted;
+  pit.extract(it2, extracted);
+  BOOST_CHECK_EQUAL(extracted.size(), 1);
+  BOOST_CHECK_EQUAL(pit.size(), 1);
+  BOOST_CHECK(pit.findSameInterest(i2) == nullptr);
+  BOOST_CHECK(pit.findSameInterest(Interest("ndn:/A")) != nullptr);
+  pit.recycle(extracted);
+}
+
+BOOST_AUTO_TEST_CASE(ManyEntries)
+{
+  PendingInterestTable pit;
+  for (int i = 0; i < 1000; ++i) {
+    Name name("ndn:/A");
+    name.append(name::Component(std::to_string(i)));
+    pit.insert(Interest(name));
+  }
+  BOOST_CHECK_EQUAL(pit.size(), 1000);
+
+  PendingInterestTable::EntryList satisfied;
+  for (int i = 0; i < 1000; ++i) {
+    Name name("ndn:/A");
+    name.append(name::Component(std::to_string(i)));
+    pit.extractDataMatches(Data(name), satisfied);
+  }
+  BOOST_CHECK_EQUAL(satisfied.size(), 1000);
+  BOOST_CHECK(pit.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Recycle)
+{
+  PendingInterestTable pit;
+  PendingInterestTable::EntryList satisfied;
+  for (int i = 0; i < 100; ++i) {
+    pit.insert(Interest("ndn:/A"));
+    pit.erase(pit.insert(Interest("ndn:/B")));
+    pit.extractDataMatches(Data("ndn:/A"), satisfied);
+    BOOST_CHECK_EQUAL(satisfied.size(), 1);
+    pit.recycle(satisfied);
+    BOOST_CHECK(satisfied.empty());
+  }
+  BOOST_CHECK(pit.empty());
+  BOOST_CHECK_EQUAL(pit.getNAllocatedEntries(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
@@ -0,0 +1,78 @@
+#include "prefix-registrar.hpp"
+#include <ndn-cxx/management/nfd-control-parameters.hpp>
+#include <ndn-cxx/management/nfd-control-response.hpp>
+
+#include "boost-test.hpp"
+#include "face-pair-fixture.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestPrefixRegistrar, FacePairFixture)
+
+BOOST_AUTO_TEST_CASE(Batch)
+{
+  // face2 acts as forwarder, and rejects prefixes under /F
+  std::vector<Name> commandPrefixes;
+  face2.listen("ndn:/localhost/nfd/rib/register", [&] (const Name&, const Interest& interest) {
+    nfd::ControlParameters parameters(interest.getName().at(4).blockFromValue());
+    commandPrefixes.push_back(parameters.getName());
+    bool isRejected = parameters.getName().at(0) == name::Component("F");
+    nfd::ControlResponse response(isRejected ? 403 : 200, "");
+    Data data(interest.getName());
+    data.setContent(response.wireEncode());
+    face2.reply(interest, data);
+  }, false);
+
+  PrefixRegistrar& registrar = face1.getPrefixRegistrar();
+  registrar.maxOutstanding = 2;
+  registrar.shouldLogFailure = false;
+
+  std::vector<PrefixRegistrar::Result> results;
+  registrar.registerPrefixes({"ndn:/A/B", "ndn:/A", "ndn:/C", "ndn:/A", "ndn:/F", "ndn:/D"},
+    [&] (const std::vector<PrefixRegistrar::Result>& r) {
+      results = r;
+      io.stop();
+    });
+  BOOST_CHECK_EQUAL(registrar.getNPending(), 6);
+
+  boost::asio::deadline_timer timeout(io, boost::posix_time::seconds(4));
+  timeout.async_wait([this] (const boost::system::error_code& ec) {
+    if (!ec) {
+      io.stop();
+    }
+  });
+  io.run();
+
+  // shorter prefixes are sent first; covered and duplicate prefixes are not sent
+  BOOST_CHECK_EQUAL(commandPrefixes.size(), 4);
+  BOOST_REQUIRE_EQUAL(results.size(), 6);
+  BOOST_CHECK(results[0].isSuccess);
+  BOOST_CHECK_EQUAL(results[0].coveredBy, Name("ndn:/A"));
+  BOOST_CHECK(results[1].isSuccess);
+  BOOST_CHECK(results[1].coveredBy.empty());
+  BOOST_CHECK(results[3].isSuccess);
+  BOOST_CHECK_EQUAL(results[4].prefix, Name("ndn:/F"));
+  BOOST_CHECK(!results[4].isSuccess);
+  BOOST_CHECK(results[5].isSuccess);
+
+  const PrefixRegistrar::Counters& cnt = registrar.getCounters();
+  BOOST_CHECK_EQUAL(cnt.nRequested, 6);
+  BOOST_CHECK_EQUAL(cnt.nCommands, 4);
+  BOOST_CHECK_EQUAL(cnt.nCovered, 2);
+  BOOST_CHECK_EQUAL(cnt.nSucceeded, 5);
+  BOOST_CHECK_EQUAL(cnt.nFailed, 1);
+  BOOST_CHECK_EQUAL(registrar.getNPending(), 0);
+
+  // a prefix covered by a registered prefix completes immediately
+  bool isCovered = false;
+  registrar.registerPrefix("ndn:/C/D", [&] (const PrefixRegistrar::Result& result) {
+    isCovered = result.isSuccess && result.coveredBy == Name("ndn:/C");
+  });
+  BOOST_CHECK(isCovered);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
@@ -0,0 +1,80 @@
+#include "rate-controller.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestRateController)
+
+BOOST_AUTO_TEST_CASE(FindFlow)
+{
+  RateController rc;
+  BOOST_CHECK(!rc.isEnabled());
+  BOOST_CHECK(rc.findFlow("ndn:/A/B") == nullptr);
+
+  RateController::Flow& flowA = rc.enable("ndn:/A");
+  RateController::Flow& flowAB = rc.enable("ndn:/A/B");
+  BOOST_CHECK(&rc.enable("ndn:/A") == &flowA);
+  BOOST_CHECK(rc.isEnabled());
+
+  BOOST_CHECK(rc.findFlow("ndn:/A/B/C") == &flowAB);
+  BOOST_CHECK(rc.findFlow("ndn:/A/C") == &flowA);
+  BOOST_CHECK(rc.findFlow("ndn:/C") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Aimd)
+{
+  RateController rc;
+  rc.initialWindow = 2.0;
+  RateController::Flow& flow = rc.enable("ndn:/A");
+  time::steady_clock::TimePoint t0 = time::steady_clock::now();
+
+  rc.onSend(flow);
+  BOOST_CHECK(rc.canSend(flow));
+  rc.onSend(flow);
+  BOOST_CHECK(!rc.canSend(flow));
+
+  // slow start
+  rc.onData(flow);
+  rc.onData(flow);
+  BOOST_CHECK_EQUAL(flow.nOutstanding, 0);
+  BOOST_CHECK_CLOSE(flow.cwnd, 4.0, 0.001);
+
+  // multiplicative decrease
+  Nack busy(Nack::BUSY, Interest("ndn:/A/1"));
+  rc.onSend(flow);
+  rc.onNack(flow, busy, t0);
+  BOOST_CHECK_CLOSE(flow.cwnd, 2.0, 0.001);
+  BOOST_CHECK_EQUAL(flow.nDecreases, 1);
+
+  // signal for a request sent before the decrease is ignored
+  rc.onSend(flow);
+  rc.onTimeout(flow, t0);
+  BOOST_CHECK_CLOSE(flow.cwnd, 2.0, 0.001);
+  BOOST_CHECK_EQUAL(flow.nCongestionSignals, 2);
+  BOOST_CHECK_EQUAL(flow.nDecreases, 1);
+
+  // other NACK codes are not congestion signals
+  rc.onSend(flow);
+  rc.onNack(flow, Nack(Nack::NODATA, Interest("ndn:/A/2")), time::steady_clock::now());
+  BOOST_CHECK_EQUAL(flow.nCongestionSignals, 2);
+
+  // additive increase
+  rc.onSend(flow);
+  rc.onData(flow);
+  BOOST_CHECK_CLOSE(flow.cwnd, 2.5, 0.001);
+
+  // window is bounded by minWindow
+  for (int i = 0; i < 4; ++i) {
+    rc.onSend(flow);
+    rc.onTimeout(flow, time::steady_clock::now());
+  }
+  BOOST_CHECK_CLOSE(flow.cwnd, 1.0, 0.001);
+  BOOST_CHECK(rc.canSend(flow));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
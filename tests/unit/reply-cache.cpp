@@ -0,0 +1,127 @@
+#include "reply-cache.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestReplyCache)
+
+static Data
+makeData(const Name& name, size_t payloadSize,
+         const time::milliseconds& freshnessPeriod = time::milliseconds(-1))
+{
+  static const uint8_t PAYLOAD[100] = {0};
+  Data data(name);
+  data.setContent(PAYLOAD, payloadSize);
+  if (freshnessPeriod >= time::milliseconds::zero()) {
+    data.setFreshnessPeriod(freshnessPeriod);
+  }
+  SignatureSha256WithRsa fakeSignature;
+  fakeSignature.setValue(dataBlock(tlv::SignatureValue, static_cast<const uint8_t*>(nullptr), 0));
+  data.setSignature(fakeSignature);
+  return data;
+}
+
+BOOST_AUTO_TEST_CASE(Match)
+{
+  ReplyCache cache;
+  cache.setCapacity(10000);
+  cache.insert(makeData("ndn:/A/1", 10));
+  cache.insert(makeData("ndn:/A/2", 10));
+  cache.insert(makeData("ndn:/B", 10));
+  BOOST_CHECK_EQUAL(cache.size(), 3);
+
+  const Data* data = cache.find(Interest("ndn:/A"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name("ndn:/A/1"));
+
+  Interest rightmost("ndn:/A");
+  rightmost.setChildSelector(1);
+  data = cache.find(rightmost);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name("ndn:/A/2"));
+
+  BOOST_CHECK(cache.find(Interest("ndn:/C")) == nullptr);
+  BOOST_CHECK(cache.find(Interest("ndn:/A/3")) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getCounters().nHits, 2);
+  BOOST_CHECK_EQUAL(cache.getCounters().nMisses, 2);
+
+  // replacing an entry does not change size
+  cache.insert(makeData("ndn:/B", 10));
+  BOOST_CHECK_EQUAL(cache.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(BoundedScan)
+{
+  ReplyCache cache;
+  cache.setCapacity(1000000);
+  for (int i = 0; i < 100; ++i) {
+    cache.insert(makeData(Name("ndn:/A").appendNumber(i), 10));
+  }
+  cache.insert(makeData("ndn:/B", 10));
+
+  Interest rightmost("ndn:/A");
+  rightmost.setChildSelector(1);
+  const Data* data = cache.find(rightmost);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name("ndn:/A").appendNumber(99));
+
+  // no entry under /A is fresh; lookup gives up after MAX_CANDIDATES entries
+  Interest fresh("ndn:/A");
+  fresh.setMustBeFresh(true);
+  BOOST_CHECK(cache.find(fresh) == nullptr);
+  fresh.setChildSelector(1);
+  BOOST_CHECK(cache.find(fresh) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Freshness)
+{
+  ReplyCache cache;
+  cache.setCapacity(10000);
+  cache.insert(makeData("ndn:/A", 10));
+  cache.insert(makeData("ndn:/B", 10, time::seconds(10)));
+
+  Interest interestA("ndn:/A");
+  interestA.setMustBeFresh(true);
+  BOOST_CHECK(cache.find(interestA) == nullptr);
+  interestA.setMustBeFresh(false);
+  BOOST_CHECK(cache.find(interestA) != nullptr);
+
+  Interest interestB("ndn:/B");
+  interestB.setMustBeFresh(true);
+  BOOST_CHECK(cache.find(interestB) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Evict)
+{
+  ReplyCache cache;
+  size_t wireSize = makeData("ndn:/0", 50).wireEncode().size();
+  cache.setCapacity(wireSize * 3);
+
+  cache.insert(makeData("ndn:/0", 50));
+  cache.insert(makeData("ndn:/1", 50));
+  cache.insert(makeData("ndn:/2", 50));
+  BOOST_CHECK_EQUAL(cache.getNBytes(), wireSize * 3);
+
+  // /0 becomes most recently used, so /1 is evicted
+  BOOST_CHECK(cache.find(Interest("ndn:/0")) != nullptr);
+  cache.insert(makeData("ndn:/3", 50));
+  BOOST_CHECK_EQUAL(cache.size(), 3);
+  BOOST_CHECK(cache.find(Interest("ndn:/1")) == nullptr);
+  BOOST_CHECK(cache.find(Interest("ndn:/0")) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getCounters().nEvictions, 1);
+
+  cache.setCapacity(wireSize);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK(cache.find(Interest("ndn:/0")) != nullptr);
+
+  cache.setCapacity(0);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+  BOOST_CHECK_EQUAL(cache.getNBytes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
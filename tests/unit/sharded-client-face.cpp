@@ -0,0 +1,92 @@
+#include "sharded-client-face.hpp"
+#include "transport/udp-transport.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestShardedClientFace)
+
+class ShardedFixture
+{
+protected:
+  ShardedFixture()
+    : producer(util::FaceUri("udp4://127.0.0.1:4041"), 4040)
+    , consumer(io, unique_ptr<Transport>(new UdpTransport(
+                     util::FaceUri("udp4://127.0.0.1:4040"), 4042)))
+  {
+    for (size_t i = 0; i < producer.size(); ++i) {
+      producer.getShard(i).shouldNackUnmatchedInterest = true;
+    }
+  }
+
+  /** \return "DATA", "NACK", or "TIMEOUT"
+   */
+  std::string
+  fetch(const Name& name)
+  {
+    std::string result = "NONE";
+    consumer.request(Interest(name),
+                     bind([&] { result = "DATA"; io.stop(); }),
+                     bind([&] { result = "NACK"; io.stop(); }),
+                     bind([&] { result = "TIMEOUT"; io.stop(); }),
+                     time::milliseconds(1000));
+    io.run();
+    io.reset();
+    return result;
+  }
+
+protected:
+  ShardedClientFace producer;
+  boost::asio::io_service io;
+  StandaloneClientFace consumer;
+};
+
+BOOST_FIXTURE_TEST_CASE(SharedListeners, ShardedFixture)
+{
+  BOOST_CHECK_GE(producer.size(), 2);
+  auto replyData = [] (ClientFace& face, const Name&, const Interest& interest) {
+    face.reply(interest, Data(interest.getName()));
+  };
+  producer.listen("ndn:/A", replyData, false);
+  producer.start();
+  BOOST_CHECK_EQUAL(fetch("ndn:/A/1"), "DATA");
+
+  // listen and unlisten while shards are running take effect on all shards
+  producer.listen("ndn:/B", replyData, false);
+  producer.unlisten("ndn:/A");
+  BOOST_CHECK_EQUAL(fetch("ndn:/B/1"), "DATA");
+  BOOST_CHECK_EQUAL(fetch("ndn:/A/2"), "NACK");
+}
+
+BOOST_FIXTURE_TEST_CASE(UnlistenInCallback, ShardedFixture)
+{
+  producer.listen("ndn:/A", [this] (ClientFace& face, const Name& prefix, const Interest& interest) {
+    producer.unlisten("ndn:/A");
+    // listener and prefix remain valid after unlisten
+    face.reply(interest, Data(Name(prefix).append("reply")));
+  }, false);
+  producer.start();
+
+  BOOST_CHECK_EQUAL(fetch("ndn:/A"), "DATA");
+  BOOST_CHECK_EQUAL(fetch("ndn:/A"), "NACK");
+}
+
+BOOST_FIXTURE_TEST_CASE(Restart, ShardedFixture)
+{
+  producer.listen("ndn:/A", [] (ClientFace& face, const Name&, const Interest& interest) {
+    face.reply(interest, Data(interest.getName()));
+  }, false);
+  producer.start();
+  BOOST_CHECK_EQUAL(fetch("ndn:/A/1"), "DATA");
+
+  producer.stop();
+  producer.start();
+  BOOST_CHECK_EQUAL(fetch("ndn:/A/2"), "DATA");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
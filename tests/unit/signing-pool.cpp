@@ -0,0 +1,61 @@
+#include "signing-pool.hpp"
+#include <set>
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestSigningPool)
+
+BOOST_AUTO_TEST_CASE(Workers)
+{
+  boost::asio::io_service io;
+  SigningPool pool(io, 2, SigningPool::DIGEST_SHA256, 4);
+
+  const size_t N_DATA = 10;
+  std::set<uint64_t> signedNumbers;
+  std::thread::id ioThread = std::this_thread::get_id();
+  for (size_t i = 0; i < N_DATA; ++i) {
+    pool.submit(Data(Name("ndn:/A").appendNumber(i)), [&] (const Data& data) {
+      BOOST_CHECK(std::this_thread::get_id() == ioThread);
+      BOOST_CHECK(static_cast<bool>(data.getSignature()));
+      signedNumbers.insert(data.getName().at(-1).toNumber());
+      if (signedNumbers.size() == N_DATA) {
+        io.stop();
+      }
+    });
+  }
+
+  boost::asio::io_service::work work(io);
+  boost::asio::deadline_timer timeout(io, boost::posix_time::seconds(4));
+  timeout.async_wait([&io] (const boost::system::error_code& ec) {
+    if (!ec) {
+      io.stop();
+    }
+  });
+  io.run();
+
+  BOOST_CHECK_EQUAL(signedNumbers.size(), N_DATA);
+  const SigningPool::Counters& cnt = pool.getCounters();
+  BOOST_CHECK_EQUAL(cnt.nSubmitted, N_DATA);
+  BOOST_CHECK_EQUAL(cnt.nWorkerSigned + cnt.nInlineSigned, N_DATA);
+  BOOST_CHECK_LE(cnt.maxQueueDepth, 4);
+  BOOST_CHECK_EQUAL(cnt.nFailed, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Inline)
+{
+  boost::asio::io_service io;
+  SigningPool pool(io, 0, SigningPool::DIGEST_SHA256);
+
+  bool isSigned = false;
+  pool.submit(Data("ndn:/A"), [&] (const Data& data) { isSigned = true; });
+  BOOST_CHECK(isSigned);
+  BOOST_CHECK_EQUAL(pool.getCounters().nInlineSigned, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
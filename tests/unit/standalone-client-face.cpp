@@ -40,6 +40,23 @@ BOOST_AUTO_TEST_CASE(RequestNack)
   BOOST_CHECK(hasNack);
 }
 
+BOOST_AUTO_TEST_CASE(RequestLpNack)
+{
+  NackCode nackCode = Nack::NONE;
+  face2.shouldEncodeNackAsLpPacket = true;
+  face2.listen("ndn:/A", [this] (const Name& prefix, const Interest& interest) {
+    face2.reply(interest, Nack(Nack::NODATA, interest));
+  });
+
+  face1.request(Interest("ndn:/A/B"),
+                bind([] { BOOST_ERROR("DATA"); }),
+                [&nackCode] (const Interest&, const Nack& nack) { nackCode = nack.getCode(); },
+                bind([] { BOOST_ERROR("TIMEOUT"); }));
+
+  io.poll();
+  BOOST_CHECK_EQUAL(nackCode, Nack::NODATA);
+}
+
 BOOST_AUTO_TEST_CASE(RequestTimeout)
 {
   Interest interest("ndn:/A/B");
@@ -58,6 +75,185 @@ BOOST_AUTO_TEST_CASE(RequestTimeout)
   BOOST_CHECK(hasTimeout);
 }
 
+BOOST_AUTO_TEST_CASE(RequestAggregate)
+{
+  face1.shouldAggregateInterests = true;
+  int nInterests = 0;
+  face2.listen("ndn:/A", [&] (const Name& prefix, const Interest& interest) {
+    ++nInterests;
+    face2.reply(interest, Data("ndn:/A/B"));
+  }, false);
+
+  int nData = 0;
+  for (int i = 0; i < 3; ++i) {
+    face1.request(Interest("ndn:/A/B"),
+                  bind([&nData] { ++nData; }),
+                  bind([] { BOOST_ERROR("NACK"); }),
+                  bind([] { BOOST_ERROR("TIMEOUT"); }));
+  }
+  Interest differentSelectors("ndn:/A/B");
+  differentSelectors.setChildSelector(1);
+  face1.request(differentSelectors,
+                bind([&nData] { ++nData; }),
+                bind([] { BOOST_ERROR("NACK"); }),
+                bind([] { BOOST_ERROR("TIMEOUT"); }));
+
+  io.poll();
+  BOOST_CHECK_EQUAL(nInterests, 2);
+  BOOST_CHECK_EQUAL(nData, 4);
+  BOOST_CHECK_EQUAL(face1.getRequestCounters().nRequests, 4);
+  BOOST_CHECK_EQUAL(face1.getRequestCounters().nAggregated, 2);
+}
+
+BOOST_AUTO_TEST_CASE(RequestAggregateTimeout)
+{
+  face1.shouldAggregateInterests = true;
+  Interest interest("ndn:/A/B");
+  interest.setInterestLifetime(time::milliseconds(10));
+
+  int nTimeouts = 0;
+  for (int i = 0; i < 2; ++i) {
+    face1.request(interest,
+                  bind([] { BOOST_ERROR("DATA"); }),
+                  bind([] { BOOST_ERROR("NACK"); }),
+                  bind([&nTimeouts] { ++nTimeouts; }));
+  }
+
+  boost::asio::deadline_timer t(io, boost::posix_time::milliseconds(20));
+  t.async_wait([this] (const boost::system::error_code&) { io.stop(); });
+
+  io.run();
+  BOOST_CHECK_EQUAL(nTimeouts, 2);
+  BOOST_CHECK_EQUAL(face1.getRequestCounters().nAggregated, 1);
+}
+
+BOOST_AUTO_TEST_CASE(RequestRateControl)
+{
+  face1.getRateController().initialWindow = 2.0;
+  RateController::Flow& flow = face1.getRateController().enable("ndn:/A");
+  std::vector<Interest> received;
+  face2.listen("ndn:/A", [&received] (const Name& prefix, const Interest& interest) {
+    received.push_back(interest);
+  }, false);
+
+  int nData = 0;
+  for (int i = 0; i < 4; ++i) {
+    face1.request(Interest(Name("ndn:/A").appendNumber(i)),
+                  bind([&nData] { ++nData; }),
+                  bind([] { BOOST_ERROR("NACK"); }),
+                  bind([] { BOOST_ERROR("TIMEOUT"); }));
+  }
+
+  io.poll();
+  BOOST_CHECK_EQUAL(received.size(), 2);
+  BOOST_CHECK_EQUAL(flow.queue.size(), 2);
+  BOOST_CHECK_EQUAL(flow.nQueued, 2);
+
+  // each Data releases one queued request, and slow start grows the window
+  face2.reply(received.at(0), Data(received.at(0).getName()));
+  io.poll();
+  BOOST_CHECK_EQUAL(received.size(), 4);
+  BOOST_CHECK_EQUAL(flow.queue.size(), 0);
+  BOOST_CHECK_EQUAL(flow.nOutstanding, 3);
+
+  for (size_t i = 1; i < received.size(); ++i) {
+    face2.reply(received[i], Data(received[i].getName()));
+  }
+  io.poll();
+  BOOST_CHECK_EQUAL(nData, 4);
+  BOOST_CHECK_EQUAL(flow.nOutstanding, 0);
+  BOOST_CHECK_CLOSE(flow.cwnd, 6.0, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(ListenLongestPrefix)
+{
+  int nShort = 0, nLong = 0;
+  face2.listen("ndn:/A", bind([&nShort] { ++nShort; }), false);
+  face2.listen("ndn:/A/B", bind([&nLong] { ++nLong; }), false);
+
+  face1.request(Interest("ndn:/A/B/C"), nullptr, nullptr, nullptr);
+  face1.request(Interest("ndn:/A/C"), nullptr, nullptr, nullptr);
+  io.poll();
+  BOOST_CHECK_EQUAL(nShort, 1);
+  BOOST_CHECK_EQUAL(nLong, 1);
+
+  face2.unlisten("ndn:/A/B");
+  face1.request(Interest("ndn:/A/B/D"), nullptr, nullptr, nullptr);
+  io.poll();
+  BOOST_CHECK_EQUAL(nShort, 2);
+  BOOST_CHECK_EQUAL(nLong, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ListenInCallback)
+{
+  // a listener that replaces and then erases itself keeps its captures and prefix
+  std::string tag = "first";
+  std::vector<std::string> replies;
+  face2.listen("ndn:/A", [this, tag, &replies] (const Name& prefix, const Interest& interest) {
+    face2.listen(prefix, bind([] { BOOST_ERROR("replaced listener invoked"); }), false);
+    face2.unlisten(prefix);
+    replies.push_back(tag + prefix.toUri());
+    face2.reply(interest, Data(interest.getName()));
+  }, false);
+
+  bool hasData = false;
+  face1.request(Interest("ndn:/A/B"),
+                bind([&hasData] { hasData = true; }),
+                bind([] { BOOST_ERROR("NACK"); }),
+                bind([] { BOOST_ERROR("TIMEOUT"); }));
+  io.poll();
+  BOOST_CHECK(hasData);
+  BOOST_REQUIRE_EQUAL(replies.size(), 1);
+  BOOST_CHECK_EQUAL(replies[0], "first/A");
+}
+
+BOOST_AUTO_TEST_CASE(ReplyTemplate)
+{
+  static const uint8_t PAYLOAD[] = {0xBB, 0xBB};
+  Data prototype;
+  prototype.setContent(PAYLOAD, sizeof(PAYLOAD));
+  DataTemplate dataTemplate(prototype);
+  face2.listen("ndn:/A", [&] (const Name& prefix, const Interest& interest) {
+    face2.reply(interest, dataTemplate, Name(interest.getName()).append("C"));
+  }, false);
+
+  bool hasData = false;
+  face1.request(Interest("ndn:/A/B"),
+                [&hasData] (const Interest& interest, const Data& data) {
+                  hasData = true;
+                  BOOST_CHECK_EQUAL(data.getName(), Name("ndn:/A/B/C"));
+                  BOOST_CHECK_EQUAL(data.getContent().value_size(), sizeof(PAYLOAD));
+                },
+                bind([] { BOOST_ERROR("NACK"); }),
+                bind([] { BOOST_ERROR("TIMEOUT"); }));
+
+  io.poll();
+  BOOST_CHECK(hasData);
+}
+
+BOOST_AUTO_TEST_CASE(ReplyCache)
+{
+  face2.getReplyCache().setCapacity(65536);
+  int nListenerCalls = 0;
+  face2.listen("ndn:/A", [&] (const Name& prefix, const Interest& interest) {
+    ++nListenerCalls;
+    face2.reply(interest, Data("ndn:/A/B"));
+  }, false);
+
+  int nData = 0;
+  for (int i = 0; i < 3; ++i) {
+    face1.request(Interest("ndn:/A/B"),
+                  bind([&nData] { ++nData; }),
+                  bind([] { BOOST_ERROR("NACK"); }),
+                  bind([] { BOOST_ERROR("TIMEOUT"); }));
+    io.poll();
+  }
+
+  BOOST_CHECK_EQUAL(nData, 3);
+  BOOST_CHECK_EQUAL(nListenerCalls, 1);
+  BOOST_CHECK_EQUAL(face2.getReplyCache().getCounters().nHits, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -3,6 +3,9 @@
 
 #include "boost-test.hpp"
 #include "../face-pair-fixture.hpp"
+#include <fstream>
+#include <map>
+#include <boost/filesystem.hpp>
 
 namespace ndn {
 namespace tests {
@@ -39,6 +42,314 @@ BOOST_AUTO_TEST_CASE(ParseOps)
   BOOST_CHECK_EQUAL(parser.read().proc, NFS_NONE);
 }
 
+BOOST_AUTO_TEST_CASE(ParseNfsProcHash)
+{
+  for (int proc = NFS_NONE + 1; proc < NFS_PROC_MAX; ++proc) {
+    const std::string& name = NfsProcStrings[proc];
+    BOOST_CHECK_EQUAL(parseNfsProc(name.data(), name.size()), proc);
+  }
+  BOOST_CHECK_EQUAL(parseNfsProc("none", 4), NFS_NONE);
+  BOOST_CHECK_EQUAL(parseNfsProc("BAD", 3), NFS_NONE);
+  BOOST_CHECK_EQUAL(parseNfsProc("rd", 2), NFS_NONE);
+  BOOST_CHECK_EQUAL(parseNfsProc("readlinkx", 9), NFS_NONE);
+}
+
+BOOST_AUTO_TEST_CASE(ParseNfsTimestamp)
+{
+  const std::string inputs[] = {"1417835239", "1417835239.5", "1417835239.0000019", "14a.0"};
+  NfsTimestamp ts = 0;
+  BOOST_CHECK(parseNfsTimestamp(inputs[0].data(), inputs[0].data() + inputs[0].size(), ts));
+  BOOST_CHECK_EQUAL(ts, 1417835239000000);
+  BOOST_CHECK(parseNfsTimestamp(inputs[1].data(), inputs[1].data() + inputs[1].size(), ts));
+  BOOST_CHECK_EQUAL(ts, 1417835239500000);
+  BOOST_CHECK(parseNfsTimestamp(inputs[2].data(), inputs[2].data() + inputs[2].size(), ts));
+  BOOST_CHECK_EQUAL(ts, 1417835239000001);
+  BOOST_CHECK(!parseNfsTimestamp(inputs[3].data(), inputs[3].data() + inputs[3].size(), ts));
+}
+
+BOOST_AUTO_TEST_CASE(ParseOpsMapped)
+{
+  std::string filename = (boost::filesystem::temp_directory_path() /
+                          boost::filesystem::unique_path()).string();
+  {
+    std::ofstream output(filename);
+    output << "BAD\n"
+              "1417835239.000000,getattr,/home/u1/f1,,,\n"
+              "1417835240.000001,BAD,/home/u2/f2,,,\n"
+              "1417835241.000003,read,/home/u3/f3,1417835241.000002,2,3\n"
+              "1417835242.000000,readdirp,/home/u4,,0,1\n"
+              "1417835243.000000,write,/home/u5/f5,1417835243.1,0,1";
+  }
+
+  {
+    MappedOpsParser parser(filename);
+    parser.acceptTimestamp = [] (const NfsTimestamp& ts) { return ts != 1417835243000000; };
+
+    auto rec1 = parser.read();
+    BOOST_CHECK_EQUAL(rec1.timestamp, 1417835239000000);
+    BOOST_CHECK_EQUAL(rec1.proc, NFS_GETATTR);
+    BOOST_CHECK_EQUAL(rec1.path, "/home/u1/f1");
+    BOOST_CHECK_EQUAL(rec1.version, 1417835239000000);
+
+    auto rec2 = parser.read();
+    BOOST_CHECK_EQUAL(rec2.timestamp, 1417835241000003);
+    BOOST_CHECK_EQUAL(rec2.proc, NFS_READ);
+    BOOST_CHECK_EQUAL(rec2.path, "/home/u3/f3");
+    BOOST_CHECK_EQUAL(rec2.version, 1417835241000002);
+    BOOST_CHECK_EQUAL(rec2.segStart, 2);
+    BOOST_CHECK_EQUAL(rec2.nSegments, 3);
+
+    // empty version is a bad input line, and last line is rejected by acceptTimestamp
+    BOOST_CHECK_EQUAL(parser.read().proc, NFS_NONE);
+    BOOST_CHECK_EQUAL(parser.read().proc, NFS_NONE);
+  }
+
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(ClientKey)
+{
+  std::string input = "1417835239.000000,getattr,/home/u1/f1,,,\n"
+                      "1417835240.000000,getattr,/home/u1/f1,,,\n"
+                      "1417835241.000003,read,/home/u3/f3,1417835241.000002,2,3,7\n"
+                      "1417835242.000000,getattr,/home/u1/f1,,,,7\n"
+                      "1417835243.000000,getattr,/home/u1/f1,,,,BAD\n";
+  std::string filename = (boost::filesystem::temp_directory_path() /
+                          boost::filesystem::unique_path()).string();
+  {
+    std::ofstream output(filename);
+    output << input;
+  }
+
+  std::stringstream is(input);
+  OpsParser parser(is);
+  MappedOpsParser mappedParser(filename);
+  for (OpsReader* reader : std::initializer_list<OpsReader*>{&parser, &mappedParser}) {
+    // without client-id column, operations on same path have same key
+    auto rec1 = reader->read();
+    auto rec2 = reader->read();
+    BOOST_CHECK_EQUAL(rec1.clientKey, hashNfsPath(rec1.path.data(), rec1.path.size()));
+    BOOST_CHECK_EQUAL(rec1.hasClientId, false);
+    BOOST_CHECK_EQUAL(rec2.clientKey, rec1.clientKey);
+
+    auto rec3 = reader->read();
+    BOOST_CHECK_EQUAL(rec3.nSegments, 3);
+    BOOST_CHECK_EQUAL(rec3.clientKey, 7);
+    BOOST_CHECK_EQUAL(rec3.hasClientId, true);
+    auto rec4 = reader->read();
+    BOOST_CHECK_EQUAL(rec4.clientKey, 7);
+
+    // non-numeric client-id is a bad input line
+    BOOST_CHECK_EQUAL(reader->read().proc, NFS_NONE);
+  }
+
+  // 32-bit FNV-1a test vectors
+  BOOST_CHECK_EQUAL(hashNfsPath("", 0), 0x811c9dc5);
+  BOOST_CHECK_EQUAL(hashNfsPath("a", 1), 0xe40c292c);
+
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(OpsBin)
+{
+  std::string opsFile = (boost::filesystem::temp_directory_path() /
+                         boost::filesystem::unique_path()).string();
+  std::string binFile = opsFile + ".opsbin";
+  {
+    std::ofstream output(opsFile);
+    output << "1417835239.000000,getattr,/home/u1/f1,,,\n"
+              "1417835241.000003,read,/home/u3/f3,1417835241.000002,2,3\n"
+              // gap exceeds 32-bit microsecond difference
+              "1417849999.000000,getattr,/home/u1/f1,,,\n"
+              // earlier than previous record
+              "1417835243.000000,write,/home/u5/f5,1417835243.1,0,1\n";
+  }
+
+  {
+    MappedOpsParser parser(opsFile);
+    OpsBinWriter writer(binFile);
+    NfsOpRef op;
+    while (parser.readRecord(op)) {
+      BOOST_CHECK(writer.append(op));
+    }
+    BOOST_REQUIRE(writer.close());
+    BOOST_CHECK_EQUAL(writer.getNPaths(), 3);
+  }
+
+  {
+    MappedOpsParser parser(opsFile);
+    OpsBinReader reader(binFile);
+    BOOST_REQUIRE(reader.isValid());
+    for (int i = 0; i < 4; ++i) {
+      NfsOp expected = parser.read();
+      NfsOp actual = reader.read();
+      BOOST_CHECK_EQUAL(actual.timestamp, expected.timestamp);
+      BOOST_CHECK_EQUAL(actual.proc, expected.proc);
+      BOOST_CHECK_EQUAL(actual.path, expected.path);
+      BOOST_CHECK_EQUAL(actual.version, expected.version);
+      BOOST_CHECK_EQUAL(actual.segStart, expected.segStart);
+      BOOST_CHECK_EQUAL(actual.nSegments, expected.nSegments);
+      BOOST_CHECK_EQUAL(actual.clientKey, expected.clientKey);
+      BOOST_CHECK_EQUAL(actual.hasClientId, expected.hasClientId);
+    }
+    BOOST_CHECK_EQUAL(reader.read().proc, NFS_NONE);
+  }
+
+  {
+    OpsBinReader reader(binFile);
+    reader.acceptTimestamp = [] (const NfsTimestamp& ts) { return ts >= 1417835241000000; };
+    NfsOpRef op;
+    BOOST_REQUIRE(reader.readRecord(op));
+    BOOST_CHECK_EQUAL(std::string(op.path, op.pathLength), "/home/u3/f3");
+  }
+
+  {
+    // .ops file is not a valid .opsbin file
+    OpsBinReader reader(opsFile);
+    BOOST_CHECK(!reader.isValid());
+    BOOST_CHECK_EQUAL(reader.read().proc, NFS_NONE);
+  }
+
+  boost::filesystem::remove(opsFile);
+  boost::filesystem::remove(binFile);
+}
+
+BOOST_AUTO_TEST_CASE(TimeScale)
+{
+  ReplayTimeScale scale;
+  BOOST_CHECK(scale.toEmulationDuration(2500000) == time::microseconds(2500000));
+
+  scale.speed = 10.0;
+  scale.begin = 1417835239000000;
+  scale.end = 1417835249000000;
+  BOOST_CHECK(scale.toEmulationDuration(1417835239000000) == time::microseconds(0));
+  BOOST_CHECK(scale.toEmulationDuration(1417835241500000) == time::microseconds(250000));
+  BOOST_CHECK(scale.toEmulationDuration(1417835238000000) == time::microseconds(-100000));
+
+  scale.speed = 0.5;
+  BOOST_CHECK(scale.toEmulationDuration(1417835241500000) == time::microseconds(5000000));
+
+  std::ostringstream os;
+  os << scale;
+  BOOST_CHECK_EQUAL(os.str(), "speed=0.5 begin=1417835239000000 end=1417835249000000");
+}
+
+BOOST_AUTO_TEST_CASE(RunnerClientIds)
+{
+  std::stringstream input(
+    "1417835239.000000,getattr,/home/u1/f1,,,,7\n"
+    "1417835240.000000,getattr,/home/u2/f2,,,,3\n"
+    "1417835241.000000,getattr,/home/u1/f3,,,,7\n"
+    "1417835242.000000,access,/home/u4/f4,,,,11\n"
+    "1417835243.000000,getattr,/home/u4/f4,,,,11\n"
+    "1417835244.000000,getattr,/home/u5/f5,,,\n"
+  );
+  OpsParser trace(input);
+
+  std::map<uint32_t, unique_ptr<Client>> clients;
+  std::map<uint32_t, unique_ptr<std::ostringstream>> logs;
+  EmulationRunner runner(trace, io);
+  // every operation is due at start
+  runner.timeScale.begin = 1417835239000000;
+  runner.timeScale.speed = 1e12;
+  runner.makeClient = [&] (uint32_t clientId) {
+    clients[clientId].reset(new Client(face1, "ndn:/NFS", makeVirtualClientHost("ndn:/C", clientId)));
+    logs[clientId].reset(new std::ostringstream);
+    runner.addClient(clientId, *clients[clientId], *logs[clientId]);
+  };
+  runner.start();
+
+  // client-ids 3, 7 and 11 would collide modulo 2; each has its own client,
+  // and operations without client-id go to client-id 0
+  BOOST_REQUIRE_EQUAL(clients.size(), 4);
+  auto getScheduledPaths = [&] (uint32_t clientId) {
+    std::vector<std::string> paths;
+    std::istringstream is(logs[clientId]->str());
+    std::string line;
+    while (std::getline(is, line)) {
+      if (line.find(",SCHED,") != std::string::npos) {
+        // path is the third field
+        size_t pathBegin = line.find(',', line.find(',') + 1) + 1;
+        paths.push_back(line.substr(pathBegin, line.find(',', pathBegin) - pathBegin));
+      }
+    }
+    return paths;
+  };
+  BOOST_CHECK((getScheduledPaths(7) == std::vector<std::string>{"/home/u1/f1", "/home/u1/f3"}));
+  BOOST_CHECK((getScheduledPaths(3) == std::vector<std::string>{"/home/u2/f2"}));
+  BOOST_CHECK((getScheduledPaths(11) == std::vector<std::string>{"/home/u4/f4"}));
+  BOOST_CHECK((getScheduledPaths(0) == std::vector<std::string>{"/home/u5/f5"}));
+  BOOST_CHECK_NE(logs[7]->str().find("pendings=2"), std::string::npos);
+  BOOST_CHECK_EQUAL(logs[3]->str().find("pendings=2"), std::string::npos);
+
+  // each client log starts with speed and window, including clients created after start
+  for (const auto& log : logs) {
+    BOOST_CHECK_EQUAL(log.second->str().substr(0, log.second->str().find('\n')),
+                      "# replay speed=1e+12 begin=1417835239000000");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RunnerWriteFetch)
+{
+  std::stringstream input("1417835239.000000,write,/home/u1/f1,1417835239.5,0,2,7\n");
+  OpsParser trace(input);
+
+  unique_ptr<Client> client;
+  std::ostringstream log;
+  EmulationRunner runner(trace, io);
+  runner.timeScale.begin = 1417835239000000;
+  runner.timeScale.speed = 1e12;
+  runner.makeClient = [&] (uint32_t clientId) {
+    client.reset(new Client(face1, "ndn:/NFS", makeVirtualClientHost("ndn:/C", clientId)));
+    runner.addClient(clientId, *client, log);
+  };
+
+  // face2 acts as server, which is reachable from the client via route ndn:/C
+  int nFetched = 0;
+  face2.listen("ndn:/NFS", [&] (const Name&, const Interest& interest) {
+    ServerAction sa = ServerAction::fromExclude(interest.getExclude());
+    if (sa.verb == SA_WRITE) {
+      const name::Component& params = stripSignature(interest.getName()).at(-1);
+      std::string s(reinterpret_cast<const char*>(params.value()), params.value_size());
+      Name clientHost(s.substr(0, s.find(':')));
+      BOOST_CHECK_EQUAL(clientHost, Name("ndn:/C/7"));
+      BOOST_REQUIRE(Name("ndn:/C").isPrefixOf(clientHost));
+
+      for (uint64_t segment = 0; segment < 2; ++segment) {
+        Name fetchName(clientHost);
+        fetchName.append("NFS").append(Name("/home/u1/f1"))
+                 .appendVersion(1417835239500000).appendSegment(segment);
+        Interest fetch(fetchName);
+        fetch.setExclude(ServerAction{SA_FETCH, 0, 0});
+        face2.request(fetch,
+            bind([&nFetched] { ++nFetched; }),
+            bind([] { BOOST_ERROR("FETCH NACK"); }),
+            bind([] { BOOST_ERROR("FETCH TIMEOUT"); }));
+      }
+    }
+    face2.reply(interest, Data(interest.getName()));
+  }, false);
+
+  runner.start();
+  for (int i = 0; i < 10 && log.str().find(",SUCCESS,") == std::string::npos; ++i) {
+    io.poll();
+  }
+
+  BOOST_CHECK_EQUAL(nFetched, 2);
+  BOOST_CHECK_NE(log.str().find("/home/u1/f1,1417835239500000,0,2,SUCCESS,"), std::string::npos);
+
+  // a completed WRITE still answers a retransmitted fetch Interest
+  Interest refetch(Name("ndn:/C/7/NFS/home/u1/f1").appendVersion(1417835239500000)
+                   .appendSegment(1));
+  refetch.setExclude(ServerAction{SA_FETCH, 0, 0});
+  face2.request(refetch,
+      bind([&nFetched] { ++nFetched; }),
+      bind([] { BOOST_ERROR("REFETCH NACK"); }),
+      bind([] { BOOST_ERROR("REFETCH TIMEOUT"); }));
+  io.poll();
+  BOOST_CHECK_EQUAL(nFetched, 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
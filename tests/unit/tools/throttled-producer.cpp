@@ -0,0 +1,247 @@
+#define NO_MAIN
+#include "../../../tools/throttled-producer.cpp"
+
+#include "util/request-auto-retry.hpp"
+
+#include "boost-test.hpp"
+#include "../face-pair-fixture.hpp"
+
+namespace ndn {
+namespace tests {
+
+using namespace ndn::throttled_producer;
+using namespace ndn::util;
+
+class ThrottledProducerFixture : public FacePairFixture
+{
+protected:
+  ThrottledProducerFixture()
+    : scheduler(io)
+    , ren(4, 4)
+    , producer(face2, scheduler, "ndn:/P", ren)
+    , nNacks(0)
+  {
+    face2.trace.connect([this] (ClientFace::TraceEventKind kind, const Interest&, NackCode) {
+      if (kind == ClientFace::TraceEventKind::NACK_TO) {
+        ++nNacks;
+      }
+    });
+  }
+
+  /** \return request Name under \p prefix, whose processing takes \p duration milliseconds
+   */
+  static Name
+  makeRequestName(const Name& prefix, uint64_t duration, uint64_t i)
+  {
+    return Name(prefix).append(name::Component(
+      boost::lexical_cast<std::string>((duration << 48) | i)));
+  }
+
+  /** \brief sends \p nRequests requests at the same time, each taking 2ms to process
+   *  \return whether all requests are satisfied
+   */
+  bool
+  requestAll(int nRequests, const NackBackoff& nackBackoff)
+  {
+    int nData = 0;
+    for (int i = 0; i < nRequests; ++i) {
+      requestAutoRetry(face1, Interest(makeRequestName("ndn:/P", 2, i)),
+                       [this, &nData, nRequests] (const Interest&, const Data&) {
+                         if (++nData == nRequests) {
+                           io.stop();
+                         }
+                       },
+                       bind([] { BOOST_ERROR("FAIL"); }),
+                       AutoRetryForever(), time::milliseconds::min(), nackBackoff);
+    }
+
+    SchedulerEventId deadline = face1.getScheduler().schedule(time::seconds(5),
+                                                               [this] { io.stop(); });
+    io.run();
+    io.reset();
+    // deadline must not stop a later run
+    face1.getScheduler().cancel(deadline);
+    return nData == nRequests;
+  }
+
+protected:
+  Scheduler scheduler;
+  RandomEarlyNack ren;
+  ThrottledProducer producer;
+  int nNacks;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestThrottledProducer, ThrottledProducerFixture)
+
+BOOST_AUTO_TEST_CASE(BackoffJitter)
+{
+  // Requests NACKed together and retried after a fixed delay arrive together again,
+  // so that most of them are NACKed again. Jitter spreads the retries over time.
+  // Jitter is seeded; NACKs are counted over several runs, because producer timing
+  // still varies between runs.
+  const int N_RUNS = 4;
+  for (int i = 0; i < N_RUNS; ++i) {
+    BOOST_REQUIRE(this->requestAll(32, NackBackoffFixed(time::milliseconds(4))));
+  }
+  int nFixedNacks = nNacks;
+
+  nNacks = 0;
+  boost::random::mt19937 gen(1);
+  NackBackoffExponential jitter(time::milliseconds(4), time::milliseconds(128),
+                                NackBackoffExponential::JITTER_FULL, [&gen] { return gen(); });
+  for (int i = 0; i < N_RUNS; ++i) {
+    BOOST_REQUIRE(this->requestAll(32, jitter));
+  }
+  BOOST_TEST_MESSAGE("fixed=" << nFixedNacks << " jitter=" << nNacks);
+  BOOST_CHECK_LT(nNacks, nFixedNacks);
+}
+
+BOOST_AUTO_TEST_CASE(RateControl)
+{
+  // Without rate control, all requests arrive together, and those beyond the queue
+  // are NACKed. With rate control, the window stays near the queue threshold.
+  BOOST_REQUIRE(this->requestAll(32, NackBackoffFixed(time::milliseconds(4))));
+  int nUncontrolledNacks = nNacks;
+
+  nNacks = 0;
+  RateController::Flow& flow = face1.getRateController().enable("ndn:/P");
+  BOOST_REQUIRE(this->requestAll(32, NackBackoffFixed(time::milliseconds(4))));
+  BOOST_TEST_MESSAGE("uncontrolled=" << nUncontrolledNacks << " controlled=" << nNacks <<
+                     " cwnd=" << flow.cwnd);
+  BOOST_CHECK_LT(nNacks, nUncontrolledNacks);
+  BOOST_CHECK_GT(flow.nQueued, 0);
+  BOOST_CHECK_EQUAL(flow.nOutstanding, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelWorkers)
+{
+  RandomEarlyNack ren8(8, 8);
+  ThrottledProducer producer4(face2, scheduler, "ndn:/Q", ren8, 4);
+
+  int nData = 0;
+  for (int i = 0; i < 4; ++i) {
+    face1.request(Interest(makeRequestName("ndn:/Q", 20, i)),
+                  [this, &nData] (const Interest&, const Data&) {
+                    if (++nData == 4) {
+                      io.stop();
+                    }
+                  },
+                  bind([] { BOOST_ERROR("NACK"); }),
+                  bind([] { BOOST_ERROR("TIMEOUT"); }));
+  }
+
+  face1.getScheduler().schedule(time::seconds(1), [this] { io.stop(); });
+  io.run();
+  BOOST_CHECK_EQUAL(nData, 4);
+
+  // no request waits as long as a service time; with a single worker,
+  // the last request would wait for three services
+  ServiceStats& stats = producer4.getStats();
+  BOOST_REQUIRE_EQUAL(stats.waits.size(), 4);
+  BOOST_CHECK(ServiceStats::percentile(stats.services, 0.0) >= time::milliseconds(20));
+  BOOST_CHECK(ServiceStats::percentile(stats.waits, 1.0) <
+              ServiceStats::percentile(stats.services, 0.0));
+}
+
+BOOST_AUTO_TEST_CASE(ShortestJobFirst)
+{
+  RandomEarlyNack ren8(8, 8);
+  ThrottledProducer producerSjf(face2, scheduler, "ndn:/S", ren8, 1,
+                                ThrottledProducer::DISCIPLINE_SJF);
+
+  // first request occupies the worker while others are queued
+  std::vector<uint64_t> durations{10, 30, 20, 5};
+  std::vector<Name> finished;
+  for (size_t i = 0; i < durations.size(); ++i) {
+    face1.request(Interest(makeRequestName("ndn:/S", durations[i], i)),
+                  [this, &finished] (const Interest&, const Data& data) {
+                    finished.push_back(data.getName());
+                    if (finished.size() == 4) {
+                      io.stop();
+                    }
+                  },
+                  bind([] { BOOST_ERROR("NACK"); }),
+                  bind([] { BOOST_ERROR("TIMEOUT"); }));
+  }
+
+  face1.getScheduler().schedule(time::seconds(1), [this] { io.stop(); });
+  io.run();
+  BOOST_REQUIRE_EQUAL(finished.size(), 4);
+  BOOST_CHECK_EQUAL(finished[0], makeRequestName("ndn:/S", 10, 0));
+  BOOST_CHECK_EQUAL(finished[1], makeRequestName("ndn:/S", 5, 3));
+  BOOST_CHECK_EQUAL(finished[2], makeRequestName("ndn:/S", 20, 2));
+  BOOST_CHECK_EQUAL(finished[3], makeRequestName("ndn:/S", 30, 1));
+}
+
+BOOST_AUTO_TEST_CASE(Codel)
+{
+  CodelNack codel(time::milliseconds(5), time::milliseconds(100));
+  time::steady_clock::TimePoint t0 = time::steady_clock::now();
+  auto at = [t0] (int ms) { return t0 + time::milliseconds(ms); };
+
+  // below target
+  BOOST_CHECK(codel.shouldProcess(time::milliseconds(1), at(0)));
+
+  // above target for less than interval
+  BOOST_CHECK(codel.shouldProcess(time::milliseconds(10), at(10)));
+  BOOST_CHECK(codel.shouldProcess(time::milliseconds(10), at(100)));
+
+  // above target for an interval: first NACK
+  BOOST_CHECK(!codel.shouldProcess(time::milliseconds(10), at(110)));
+  // next NACK is after interval/sqrt(1)
+  BOOST_CHECK(codel.shouldProcess(time::milliseconds(10), at(150)));
+  BOOST_CHECK(!codel.shouldProcess(time::milliseconds(10), at(210)));
+  // next NACK is after interval/sqrt(2)
+  BOOST_CHECK(codel.shouldProcess(time::milliseconds(10), at(270)));
+  BOOST_CHECK(!codel.shouldProcess(time::milliseconds(10), at(281)));
+
+  // leaves NACKing state when sojourn time falls below target
+  BOOST_CHECK(codel.shouldProcess(time::milliseconds(1), at(290)));
+  BOOST_CHECK(codel.shouldProcess(time::milliseconds(10), at(300)));
+}
+
+BOOST_AUTO_TEST_CASE(CodelBoundsWait)
+{
+  // one worker, requests of 10ms arriving every 5ms: without AQM, queue grows without bound
+  CodelNack codel(time::milliseconds(5), time::milliseconds(20));
+  ThrottledProducer producerCodel(face2, scheduler, "ndn:/C", codel);
+
+  int nData = 0, nNacks = 0;
+  for (int i = 0; i < 40; ++i) {
+    face1.getScheduler().schedule(time::milliseconds(5 * i), [this, i, &nData, &nNacks] {
+      face1.request(Interest(makeRequestName("ndn:/C", 10, i)),
+                    bind([&nData] { ++nData; }),
+                    bind([&nNacks] { ++nNacks; }),
+                    bind([] { BOOST_ERROR("TIMEOUT"); }));
+    });
+  }
+
+  face1.getScheduler().schedule(time::milliseconds(600), [this] { io.stop(); });
+  io.run();
+  BOOST_CHECK_EQUAL(nData + nNacks, 40);
+  BOOST_CHECK_GT(nNacks, 0);
+
+  ServiceStats& stats = producerCodel.getStats();
+  BOOST_CHECK_EQUAL(stats.nRejected, nNacks);
+  // without AQM, the last request would wait about 200ms
+  BOOST_CHECK(ServiceStats::percentile(stats.waits, 1.0) < time::milliseconds(150));
+}
+
+BOOST_AUTO_TEST_CASE(Percentile)
+{
+  std::vector<time::nanoseconds> samples;
+  BOOST_CHECK(ServiceStats::percentile(samples, 0.5) == time::nanoseconds::zero());
+
+  for (int i = 100; i >= 1; --i) {
+    samples.push_back(time::milliseconds(i));
+  }
+  BOOST_CHECK(ServiceStats::percentile(samples, 0.0) == time::milliseconds(1));
+  BOOST_CHECK(ServiceStats::percentile(samples, 0.5) == time::milliseconds(50));
+  BOOST_CHECK(ServiceStats::percentile(samples, 0.75) == time::milliseconds(75));
+  BOOST_CHECK(ServiceStats::percentile(samples, 1.0) == time::milliseconds(100));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
@@ -33,7 +33,10 @@ public:
   virtual void
   send(const Block& header, const Block& payload)
   {
-    BOOST_ASSERT_MSG(false, "not implemented");
+    auto buffer = make_shared<Buffer>(header.size() + payload.size());
+    std::copy(header.wire(), header.wire() + header.size(), buffer->begin());
+    std::copy(payload.wire(), payload.wire() + payload.size(), buffer->begin() + header.size());
+    this->send(Block(buffer));
   }
 
   virtual void
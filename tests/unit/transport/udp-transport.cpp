@@ -1,4 +1,5 @@
 #include "transport/udp-transport.hpp"
+#include <ndn-cxx/encoding/block-helpers.hpp>
 
 #include "boost-test.hpp"
 
@@ -16,12 +17,303 @@ BOOST_AUTO_TEST_CASE(UdpPair)
   transport1.connect(io, bind([]{}));
   transport2.connect(io, [&] (const Block& block) {
     BOOST_CHECK_EQUAL(block.type(), 0x01);
+    // by default, even a small Block refers to receive buffer without copying
+    BOOST_CHECK_EQUAL(block.getBuffer()->size(), ndn::MAX_NDN_PACKET_SIZE);
     io.stop();
   });
 
   Block block(0x01);
   block.encode();
   transport1.send(block);
+
+  bool hasTimeout = false;
+  boost::asio::deadline_timer timeout(io, boost::posix_time::seconds(2));
+  timeout.async_wait([&] (const boost::system::error_code& ec) {
+    if (!ec) {
+      hasTimeout = true;
+      io.stop();
+    }
+  });
+  io.run();
+  BOOST_CHECK(!hasTimeout);
+}
+
+BOOST_AUTO_TEST_CASE(Batched)
+{
+  boost::asio::io_service io;
+  UdpTransport transport1(ndn::util::FaceUri("udp4://127.0.0.1:4004"), 4003);
+  UdpTransport transport2(ndn::util::FaceUri("udp4://127.0.0.1:4003"), 4004);
+  transport1.batchSize = 16;
+  transport2.batchSize = 16;
+
+  const int N_BLOCKS = 40;
+  int nReceived = 0;
+  transport1.connect(io, bind([]{}));
+  transport2.connect(io, [&] (const Block& block) {
+    BOOST_CHECK_EQUAL(block.type(), 0x01);
+    if (++nReceived == N_BLOCKS) {
+      io.stop();
+    }
+  });
+
+  Block block(0x01);
+  block.encode();
+  for (int i = 0; i < N_BLOCKS; ++i) {
+    transport1.send(block);
+  }
+
+  boost::asio::deadline_timer timeout(io, boost::posix_time::seconds(2));
+  timeout.async_wait([&io] (const boost::system::error_code& ec) {
+    if (!ec) {
+      io.stop();
+    }
+  });
+  io.run();
+
+  BOOST_CHECK_EQUAL(nReceived, N_BLOCKS);
+  const UdpTransport::BatchCounters& sendCounters = transport1.getBatchCounters();
+  BOOST_CHECK_EQUAL(sendCounters.nSendDatagrams, N_BLOCKS);
+  BOOST_CHECK_EQUAL(sendCounters.nSendBatches, 3); // 16+16+8
+  BOOST_CHECK_EQUAL(sendCounters.maxSendBatch, 16);
+  const UdpTransport::BatchCounters& recvCounters = transport2.getBatchCounters();
+  BOOST_CHECK_EQUAL(recvCounters.nRecvDatagrams, N_BLOCKS);
+  BOOST_CHECK_LE(recvCounters.maxRecvBatch, 16);
+}
+
+BOOST_AUTO_TEST_CASE(CloseBeforeFlush)
+{
+  boost::asio::io_service io;
+  {
+    UdpTransport transport(ndn::util::FaceUri("udp4://127.0.0.1:4004"), 4003);
+    transport.batchSize = 16;
+    transport.connect(io, bind([]{}));
+
+    Block block(0x01);
+    block.encode();
+    transport.send(block);
+    transport.close();
+  }
+  // posted flush handler runs after the transport is destructed
+  BOOST_CHECK_NO_THROW(io.poll());
+}
+
+BOOST_AUTO_TEST_CASE(RecvBufferReuse)
+{
+  boost::asio::io_service io;
+  UdpTransport transport1(ndn::util::FaceUri("udp4://127.0.0.1:4006"), 4005);
+  UdpTransport transport2(ndn::util::FaceUri("udp4://127.0.0.1:4005"), 4006);
+  transport2.recvCopyThreshold = 2048;
+  transport2.maxRecvBuffers = 4;
+
+  const size_t N_BLOCKS = 20;
+  const size_t LARGE_SIZE = 4000;
+  bool shouldRetain = true;
+  std::vector<Block> retained;
+  size_t nReceived = 0;
+  transport1.connect(io, bind([]{}));
+  transport2.connect(io, [&] (const Block& block) {
+    if (block.size() > transport2.recvCopyThreshold) {
+      // large Block refers to receive buffer without copying
+      BOOST_CHECK_EQUAL(block.getBuffer()->size(), ndn::MAX_NDN_PACKET_SIZE);
+    }
+    else {
+      // small Block is copied into a buffer of its own size
+      BOOST_CHECK_EQUAL(block.getBuffer()->size(), block.size());
+    }
+    if (shouldRetain) {
+      retained.push_back(block);
+    }
+    if (++nReceived == N_BLOCKS) {
+      io.stop();
+    }
+  });
+
+  boost::asio::deadline_timer timeout(io);
+  auto runRound = [&] (bool isLarge) {
+    nReceived = 0;
+    for (size_t i = 0; i < N_BLOCKS; ++i) {
+      Block block(0x80);
+      block.push_back(makeNonNegativeIntegerBlock(0x01, i));
+      if (isLarge) {
+        std::vector<uint8_t> padding(LARGE_SIZE);
+        block.push_back(makeBinaryBlock(0x02, padding.data(), padding.size()));
+      }
+      block.encode();
+      transport1.send(block);
+    }
+    timeout.expires_from_now(boost::posix_time::seconds(2));
+    timeout.async_wait([&io] (const boost::system::error_code& ec) {
+      if (!ec) {
+        io.stop();
+      }
+    });
+    io.run();
+    io.reset();
+    timeout.cancel();
+  };
+
+  // small Blocks do not pin receive buffers
+  runRound(false);
+  BOOST_REQUIRE_EQUAL(retained.size(), N_BLOCKS);
+  BOOST_CHECK_LE(transport2.getNRecvBuffers(), 1);
+  retained.clear();
+
+  // large Blocks pin receive buffers
+  runRound(true);
+  BOOST_REQUIRE_EQUAL(retained.size(), N_BLOCKS);
+  for (size_t i = 0; i < N_BLOCKS; ++i) {
+    // a retained Block is not overwritten by later datagrams
+    retained[i].parse();
+    BOOST_CHECK_EQUAL(readNonNegativeInteger(retained[i].get(0x01)), i);
+  }
+  BOOST_CHECK_GT(transport2.getNRecvBuffers(), N_BLOCKS);
+
+  // released buffers beyond maxRecvBuffers are freed
+  retained.clear();
+  BOOST_CHECK_LE(transport2.getNRecvBuffers(), 5);
+
+  shouldRetain = false;
+  runRound(true);
+  BOOST_CHECK_EQUAL(nReceived, N_BLOCKS);
+  BOOST_CHECK_LE(transport2.getNRecvBuffers(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(HeaderPayload)
+{
+  boost::asio::io_service io;
+  UdpTransport transport1(ndn::util::FaceUri("udp4://127.0.0.1:4008"), 4007);
+  UdpTransport transport2(ndn::util::FaceUri("udp4://127.0.0.1:4007"), 4008);
+  transport1.batchSize = 4;
+
+  Block payload = makeNonNegativeIntegerBlock(0x01, 7);
+  // header is TLV-TYPE and TLV-LENGTH of an outer element enclosing payload
+  auto headerBuffer = make_shared<Buffer>();
+  headerBuffer->push_back(0x64);
+  headerBuffer->push_back(payload.size());
+  Block header(headerBuffer, headerBuffer->begin(), headerBuffer->end(), false);
+
+  int nReceived = 0;
+  transport1.connect(io, bind([]{}));
+  transport2.connect(io, [&] (const Block& block) {
+    BOOST_CHECK_EQUAL(block.type(), 0x64);
+    BOOST_CHECK_EQUAL(block.size(), header.size() + payload.size());
+    BOOST_CHECK(std::equal(payload.wire(), payload.wire() + payload.size(), block.value()));
+    if (++nReceived == 2) {
+      io.stop();
+    }
+  });
+
+  transport1.send(header, payload);
+  transport1.send(header, payload);
+
+  boost::asio::deadline_timer timeout(io, boost::posix_time::seconds(2));
+  timeout.async_wait([&io] (const boost::system::error_code& ec) {
+    if (!ec) {
+      io.stop();
+    }
+  });
+  io.run();
+
+  BOOST_CHECK_EQUAL(nReceived, 2);
+  BOOST_CHECK_EQUAL(transport1.getBatchCounters().nSendDatagrams, 2);
+}
+
+BOOST_AUTO_TEST_CASE(ReusePort)
+{
+  boost::asio::io_service io;
+  // two transports share local port 4010, each connected to a different remote
+  UdpTransport shardA(ndn::util::FaceUri("udp4://127.0.0.1:4011"), 4010);
+  UdpTransport shardB(ndn::util::FaceUri("udp4://127.0.0.1:4012"), 4010);
+  shardA.shouldReusePort = shardB.shouldReusePort = true;
+  UdpTransport remoteA(ndn::util::FaceUri("udp4://127.0.0.1:4010"), 4011);
+  UdpTransport remoteB(ndn::util::FaceUri("udp4://127.0.0.1:4010"), 4012);
+
+  std::vector<uint64_t> receivedA, receivedB;
+  auto checkDone = [&] {
+    if (receivedA.size() + receivedB.size() == 6) {
+      io.stop();
+    }
+  };
+  shardA.connect(io, [&] (const Block& block) {
+    receivedA.push_back(readNonNegativeInteger(block));
+    checkDone();
+  });
+  shardB.connect(io, [&] (const Block& block) {
+    receivedB.push_back(readNonNegativeInteger(block));
+    checkDone();
+  });
+  remoteA.connect(io, bind([]{}));
+  remoteB.connect(io, bind([]{}));
+
+  for (int i = 0; i < 3; ++i) {
+    remoteA.send(makeNonNegativeIntegerBlock(0x01, 1));
+    remoteB.send(makeNonNegativeIntegerBlock(0x01, 2));
+  }
+
+  boost::asio::deadline_timer timeout(io, boost::posix_time::seconds(2));
+  timeout.async_wait([&io] (const boost::system::error_code& ec) {
+    if (!ec) {
+      io.stop();
+    }
+  });
+  io.run();
+
+  BOOST_CHECK(receivedA == std::vector<uint64_t>(3, 1));
+  BOOST_CHECK(receivedB == std::vector<uint64_t>(3, 2));
+}
+
+BOOST_AUTO_TEST_CASE(Unconnected)
+{
+  for (size_t batchSize : {1, 16}) {
+    BOOST_TEST_MESSAGE("batchSize=" << batchSize);
+    boost::asio::io_service io;
+    UdpTransport transport(ndn::util::FaceUri("udp4://127.0.0.1:4014"), 4013);
+    transport.shouldConnect = false;
+    transport.batchSize = batchSize;
+    UdpTransport remote(ndn::util::FaceUri("udp4://127.0.0.1:4013"), 4014);
+    UdpTransport peerA(ndn::util::FaceUri("udp4://127.0.0.1:4013"), 4015);
+    UdpTransport peerB(ndn::util::FaceUri("udp4://127.0.0.1:4013"), 4016);
+
+    std::vector<uint64_t> receivedRemote, receivedA, receivedB;
+    auto checkDone = [&] {
+      if (receivedRemote.size() + receivedA.size() + receivedB.size() == 3) {
+        io.stop();
+      }
+    };
+    // datagrams from any source are accepted, and replies go back to their sources
+    transport.connect(io, [&] (const Block& block) {
+      transport.send(block);
+    });
+    remote.connect(io, [&] (const Block& block) {
+      receivedRemote.push_back(readNonNegativeInteger(block));
+      checkDone();
+    });
+    peerA.connect(io, [&] (const Block& block) {
+      receivedA.push_back(readNonNegativeInteger(block));
+      checkDone();
+    });
+    peerB.connect(io, [&] (const Block& block) {
+      receivedB.push_back(readNonNegativeInteger(block));
+      checkDone();
+    });
+
+    peerA.send(makeNonNegativeIntegerBlock(0x01, 1));
+    peerB.send(makeNonNegativeIntegerBlock(0x01, 2));
+    // a Block sent outside of receive callback goes to the remote endpoint
+    transport.send(makeNonNegativeIntegerBlock(0x01, 3));
+
+    boost::asio::deadline_timer timeout(io, boost::posix_time::seconds(2));
+    timeout.async_wait([&io] (const boost::system::error_code& ec) {
+      if (!ec) {
+        io.stop();
+      }
+    });
+    io.run();
+
+    BOOST_CHECK(receivedA == std::vector<uint64_t>(1, 1));
+    BOOST_CHECK(receivedB == std::vector<uint64_t>(1, 2));
+    BOOST_CHECK(receivedRemote == std::vector<uint64_t>(1, 3));
+  }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
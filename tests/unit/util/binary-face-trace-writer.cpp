@@ -0,0 +1,109 @@
+#include "util/binary-face-trace-writer.hpp"
+
+#include "boost-test.hpp"
+#include "../face-pair-fixture.hpp"
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace tests {
+
+using ndn::util::BinaryFaceTraceWriter;
+using ndn::util::decodeBinaryFaceTrace;
+
+class BinaryFaceTraceWriterFixture : public FacePairFixture
+{
+protected:
+  BinaryFaceTraceWriterFixture()
+    : filename((boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path()).string())
+  {
+  }
+
+  ~BinaryFaceTraceWriterFixture()
+  {
+    boost::filesystem::remove(filename);
+  }
+
+protected:
+  std::string filename;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestBinaryFaceTraceWriter, BinaryFaceTraceWriterFixture)
+
+BOOST_AUTO_TEST_CASE(WriteDecode)
+{
+  face2.listen("ndn:/A", [this] (const Name& prefix, const Interest& interest) {
+    if (interest.getName().size() == 2) {
+      face2.reply(interest, Data(interest.getName()));
+    }
+    else {
+      face2.reply(interest, Nack(Nack::BUSY, interest));
+    }
+  }, false);
+
+  {
+    BinaryFaceTraceWriter writer(filename);
+    writer.connect(face1);
+    face1.request(Interest("ndn:/A/B"), nullptr, nullptr, nullptr);
+    face1.request(Interest("ndn:/A/B/C"), nullptr, nullptr, nullptr);
+    face1.request(Interest("ndn:/A/B"), nullptr, nullptr, nullptr);
+    io.poll();
+    BOOST_CHECK_EQUAL(writer.getNDropped(), 0);
+  }
+
+  std::ifstream input(filename, std::ios::binary);
+  std::stringstream output;
+  BOOST_REQUIRE(decodeBinaryFaceTrace(input, output));
+
+  std::vector<std::string> events;
+  std::string line;
+  while (std::getline(output, line)) {
+    // strip timestamp
+    events.push_back(line.substr(line.find(' ') + 1));
+  }
+  BOOST_CHECK_EQUAL(events.size(), 6);
+  BOOST_CHECK(std::count(events.begin(), events.end(),
+                         "[FaceTrace] /A/B interestTo 0") == 2);
+  BOOST_CHECK(std::count(events.begin(), events.end(),
+                         "[FaceTrace] /A/B dataFrom 0") == 2);
+  BOOST_CHECK(std::count(events.begin(), events.end(),
+                         "[FaceTrace] /A/B/C nackFrom 0 BUSY") == 1);
+}
+
+BOOST_AUTO_TEST_CASE(NameTableEviction)
+{
+  face2.listen("ndn:/A", [this] (const Name& prefix, const Interest& interest) {
+    face2.reply(interest, Data(interest.getName()));
+  }, false);
+
+  {
+    // every name maps to the only slot, so that each name evicts the previous one
+    BinaryFaceTraceWriter writer(filename, 65536, 1);
+    writer.connect(face1);
+    face1.request(Interest("ndn:/A/B"), nullptr, nullptr, nullptr);
+    face1.request(Interest("ndn:/A/C"), nullptr, nullptr, nullptr);
+    face1.request(Interest("ndn:/A/B"), nullptr, nullptr, nullptr);
+    io.poll();
+  }
+
+  std::ifstream input(filename, std::ios::binary);
+  std::stringstream output;
+  BOOST_REQUIRE(decodeBinaryFaceTrace(input, output));
+
+  std::vector<std::string> events;
+  std::string line;
+  while (std::getline(output, line)) {
+    events.push_back(line.substr(line.find(' ') + 1));
+  }
+  BOOST_CHECK(std::count(events.begin(), events.end(),
+                         "[FaceTrace] /A/B interestTo 0") == 2);
+  BOOST_CHECK(std::count(events.begin(), events.end(),
+                         "[FaceTrace] /A/C interestTo 0") == 1);
+  BOOST_CHECK(std::count(events.begin(), events.end(),
+                         "[FaceTrace] /A/C dataFrom 0") == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
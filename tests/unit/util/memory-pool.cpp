@@ -0,0 +1,57 @@
+#include "util/memory-pool.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+using ndn::util::MemoryPool;
+
+BOOST_AUTO_TEST_SUITE(TestMemoryPool)
+
+BOOST_AUTO_TEST_CASE(Reuse)
+{
+  MemoryPool pool;
+  void* p1 = pool.allocate(40);
+  void* p2 = pool.allocate(100);
+  BOOST_CHECK_EQUAL(pool.getNSystemAllocations(), 2);
+  BOOST_CHECK_EQUAL(pool.getNInUse(), 2);
+
+  pool.deallocate(p1, 40);
+  BOOST_CHECK_EQUAL(pool.getNInUse(), 1);
+
+  // same size class
+  void* p3 = pool.allocate(48);
+  BOOST_CHECK_EQUAL(p3, p1);
+  BOOST_CHECK_EQUAL(pool.getNSystemAllocations(), 2);
+
+  // different size class
+  void* p4 = pool.allocate(10);
+  BOOST_CHECK_EQUAL(pool.getNSystemAllocations(), 3);
+
+  pool.deallocate(p2, 100);
+  pool.deallocate(p3, 48);
+  pool.deallocate(p4, 10);
+  BOOST_CHECK_EQUAL(pool.getNInUse(), 0);
+  BOOST_CHECK_EQUAL(pool.getNAllocations(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(ConstructDestroy)
+{
+  MemoryPool pool;
+  auto counter = make_shared<int>(0);
+
+  for (int i = 0; i < 10; ++i) {
+    auto p = pool.construct<shared_ptr<int>>(counter);
+    BOOST_CHECK_EQUAL(counter.use_count(), 2);
+    pool.destroy(p);
+    BOOST_CHECK_EQUAL(counter.use_count(), 1);
+  }
+  BOOST_CHECK_EQUAL(pool.getNSystemAllocations(), 1);
+  BOOST_CHECK_EQUAL(pool.getNInUse(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
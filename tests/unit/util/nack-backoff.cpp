@@ -0,0 +1,101 @@
+#include "util/nack-backoff.hpp"
+#include <set>
+#include <boost/random/mersenne_twister.hpp>
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+using namespace ndn::util;
+
+BOOST_AUTO_TEST_SUITE(TestNackBackoff)
+
+BOOST_AUTO_TEST_CASE(Exponential)
+{
+  Nack nack(Nack::BUSY, Interest("ndn:/A"));
+  NackBackoffExponential backoff(time::milliseconds(10), time::milliseconds(50),
+                                 NackBackoffExponential::JITTER_NONE);
+  BOOST_CHECK(backoff(1, nack) == time::milliseconds(10));
+  BOOST_CHECK(backoff(2, nack) == time::milliseconds(20));
+  BOOST_CHECK(backoff(3, nack) == time::milliseconds(40));
+  BOOST_CHECK(backoff(4, nack) == time::milliseconds(50));
+  BOOST_CHECK(backoff(100, nack) == time::milliseconds(50));
+}
+
+BOOST_AUTO_TEST_CASE(FullJitter)
+{
+  Nack nack(Nack::BUSY, Interest("ndn:/A"));
+  NackBackoffExponential backoff(time::milliseconds(10), time::milliseconds(50),
+                                 NackBackoffExponential::JITTER_FULL);
+  std::set<time::milliseconds> delays;
+  for (int i = 0; i < 200; ++i) {
+    time::milliseconds delay = backoff(3, nack);
+    BOOST_CHECK(delay >= time::milliseconds::zero());
+    BOOST_CHECK(delay <= time::milliseconds(40));
+    delays.insert(delay);
+  }
+  BOOST_CHECK_GT(delays.size(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(SeededJitter)
+{
+  Nack nack(Nack::BUSY, Interest("ndn:/A"));
+  auto makeDelays = [&nack] (uint32_t seed) -> std::vector<time::milliseconds> {
+    boost::random::mt19937 gen(seed);
+    NackBackoffExponential backoff(time::milliseconds(10), time::milliseconds(500),
+                                   NackBackoffExponential::JITTER_FULL,
+                                   [&gen] { return gen(); });
+    std::vector<time::milliseconds> delays;
+    for (int i = 1; i <= 20; ++i) {
+      delays.push_back(backoff(i, nack));
+    }
+    return delays;
+  };
+
+  // same seed gives same delays
+  BOOST_CHECK(makeDelays(1) == makeDelays(1));
+  BOOST_CHECK(makeDelays(1) != makeDelays(2));
+}
+
+BOOST_AUTO_TEST_CASE(DecorrelatedJitter)
+{
+  Nack nack(Nack::BUSY, Interest("ndn:/A"));
+  NackBackoffExponential backoff(time::milliseconds(10), time::milliseconds(500),
+                                 NackBackoffExponential::JITTER_DECORRELATED);
+  time::milliseconds prev(10);
+  for (int i = 1; i <= 50; ++i) {
+    time::milliseconds delay = backoff(i, nack);
+    BOOST_CHECK(delay >= time::milliseconds(10));
+    BOOST_CHECK(delay <= std::min(prev * 3, time::milliseconds(500)));
+    prev = delay;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PerCode)
+{
+  NackBackoffPerCode backoff(NackBackoffFixed(time::milliseconds(1)));
+  backoff.set(Nack::BUSY, NackBackoffFixed(time::milliseconds(2)))
+         .set(Nack::DUPLICATE, NackBackoffFixed(time::milliseconds(3)));
+
+  Interest interest("ndn:/A");
+  BOOST_CHECK(backoff(1, Nack(Nack::BUSY, interest)) == time::milliseconds(2));
+  BOOST_CHECK(backoff(1, Nack(Nack::DUPLICATE, interest)) == time::milliseconds(3));
+  BOOST_CHECK(backoff(1, Nack(Nack::GIVEUP, interest)) == time::milliseconds(1));
+}
+
+BOOST_AUTO_TEST_CASE(RetryAfter)
+{
+  NackBackoffRetryAfter backoff(NackBackoffFixed(time::milliseconds(5)));
+
+  Nack nack(Nack::BUSY, Interest("ndn:/A"));
+  BOOST_CHECK(backoff(1, nack) == time::milliseconds(5));
+
+  nack.setRetryAfter(time::milliseconds(300));
+  BOOST_CHECK(backoff(1, nack) == time::milliseconds(305));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
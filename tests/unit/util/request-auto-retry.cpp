@@ -1,13 +1,51 @@
 #include "util/request-auto-retry.hpp"
+#include "util/timing-wheel-scheduler.hpp"
 
 #include "boost-test.hpp"
 #include "../face-pair-fixture.hpp"
+#include "../allocation-counter.hpp"
 
 namespace ndn {
 namespace tests {
 
 using ndn::util::requestAutoRetry;
 using ndn::util::AutoRetryLimited;
+using ndn::util::AUTO_RETRY_ADAPTIVE;
+using ndn::util::NackBackoffFixed;
+
+/** \brief a face that discards sent packets, and lets the test deliver Data
+ */
+class DiscardFace : public ClientFace
+{
+public:
+  explicit
+  DiscardFace(boost::asio::io_service& io)
+    : m_scheduler(io)
+  {
+  }
+
+  virtual util::SchedulerBase&
+  getScheduler() NDNCXXEXT_DECL_OVERRIDE
+  {
+    return m_scheduler;
+  }
+
+  using ClientFace::receiveData;
+
+private:
+  virtual void
+  sendElement(const Block& block) NDNCXXEXT_DECL_OVERRIDE
+  {
+  }
+
+  virtual void
+  registerPrefix(const Name& prefix) NDNCXXEXT_DECL_OVERRIDE
+  {
+  }
+
+private:
+  util::TimingWheelScheduler m_scheduler;
+};
 
 BOOST_FIXTURE_TEST_SUITE(TestRequestAutoRetry, FacePairFixture)
 
@@ -29,7 +67,8 @@ BOOST_AUTO_TEST_CASE(NackTwice)
   requestAutoRetry(face1, Interest("ndn:/A/B"),
                    bind([&hasData] { hasData = true; }),
                    bind([] { BOOST_ERROR("FAIL"); }),
-                   AutoRetryLimited(4), time::milliseconds::min(), time::milliseconds(3));
+                   AutoRetryLimited(4), time::milliseconds::min(),
+                   NackBackoffFixed(time::milliseconds(3)));
 
   face1.getScheduler().schedule(time::milliseconds(12), [&io] { io.stop(); });
   io.run();
@@ -37,6 +76,115 @@ BOOST_AUTO_TEST_CASE(NackTwice)
   BOOST_CHECK(hasData);
 }
 
+BOOST_AUTO_TEST_CASE(AdaptiveRetx)
+{
+  int nReceiveInterest = 0;
+  face2.listen("ndn:/A", [this, &nReceiveInterest] (const Name& prefix, const Interest& interest) {
+    // drop first transmission of second request
+    if (++nReceiveInterest != 2) {
+      face2.reply(interest, Data(interest.getName()));
+    }
+  });
+  face1.getRttEstimator().minRto = time::milliseconds(10);
+
+  int nData = 0;
+  requestAutoRetry(face1, Interest("ndn:/A/1"),
+    bind([this, &nData] {
+      ++nData;
+      BOOST_CHECK_EQUAL(face1.getRttEstimator().getNMeasurements(), 1);
+      requestAutoRetry(face1, Interest("ndn:/A/2"),
+                       bind([&nData] { ++nData; }),
+                       bind([] { BOOST_ERROR("FAIL"); }),
+                       AutoRetryLimited(2), AUTO_RETRY_ADAPTIVE);
+    }),
+    bind([] { BOOST_ERROR("FAIL"); }),
+    AutoRetryLimited(1), AUTO_RETRY_ADAPTIVE);
+
+  // Interest lifetime is 4s; retransmission must be triggered by RTO
+  face1.getScheduler().schedule(time::milliseconds(200), [this] { io.stop(); });
+  io.run();
+
+  BOOST_CHECK_EQUAL(nData, 2);
+  BOOST_CHECK_EQUAL(nReceiveInterest, 3);
+  // retransmitted request is not measured
+  BOOST_CHECK_EQUAL(face1.getRttEstimator().getNMeasurements(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(PoolRecycling)
+{
+  // this checks the request pool and PIT entries on a face with transport and default scheduler;
+  // SteadyStateAllocation checks heap allocations
+  face2.listen("ndn:/A", [this] (const Name& prefix, const Interest& interest) {
+    face2.reply(interest, Data(interest.getName()));
+  });
+
+  int nData = 0;
+  std::function<void()> sendNext = [&] {
+    requestAutoRetry(face1, Interest(Name("ndn:/A").appendNumber(nData)),
+                     bind([&] {
+                       if (++nData < 200) {
+                         sendNext();
+                       }
+                       else {
+                         io.stop();
+                       }
+                     }),
+                     bind([] { BOOST_ERROR("FAIL"); }),
+                     AutoRetryLimited(1));
+  };
+
+  // warm up
+  nData = 0;
+  sendNext();
+  io.run();
+  BOOST_REQUIRE_EQUAL(nData, 200);
+  size_t nSystemAllocations = face1.getRequestPool().getNSystemAllocations();
+  size_t nAllocatedPendingInterests = face1.getNAllocatedPendingInterests();
+
+  nData = 0;
+  io.reset();
+  sendNext();
+  io.run();
+  BOOST_REQUIRE_EQUAL(nData, 200);
+  BOOST_CHECK_EQUAL(face1.getRequestPool().getNSystemAllocations(), nSystemAllocations);
+  BOOST_CHECK_EQUAL(face1.getNAllocatedPendingInterests(), nAllocatedPendingInterests);
+  BOOST_CHECK_EQUAL(face1.getRequestPool().getNInUse(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SteadyStateAllocation)
+{
+  DiscardFace face(io);
+
+  // packets are encoded before measurement, so that only per-request state is measured
+  Interest interest("ndn:/A/B");
+  interest.wireEncode();
+  Data data("ndn:/A/B");
+  DataTemplate::addFakeSignature(data);
+  data.wireEncode();
+
+  int nData = 0;
+  auto requestAndReply = [&] {
+    requestAutoRetry(face, interest,
+                     [&nData] (const Interest&, Data&) { ++nData; },
+                     [] (const Interest&) { BOOST_ERROR("FAIL"); },
+                     AutoRetryLimited(1));
+    face.receiveData(data);
+  };
+
+  // warm up request pool, PIT entries and scheduler free lists
+  for (int i = 0; i < 16; ++i) {
+    requestAndReply();
+  }
+
+  size_t nHeapAllocations = getNHeapAllocations();
+  for (int i = 0; i < 1000; ++i) {
+    requestAndReply();
+  }
+  BOOST_CHECK_EQUAL(getNHeapAllocations() - nHeapAllocations, 0);
+  BOOST_CHECK_EQUAL(nData, 1016);
+  BOOST_CHECK_EQUAL(face.getRequestPool().getNInUse(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -8,6 +8,8 @@ namespace tests {
 
 using ndn::util::requestSegments;
 using ndn::util::AutoRetryLimited;
+using ndn::util::SegmentPipelineFixed;
+using ndn::util::SegmentPipelineAimd;
 
 class RequestSegmentsProducerFixture : public FacePairFixture
 {
@@ -62,6 +64,128 @@ BOOST_AUTO_TEST_CASE(AllSegments)
   BOOST_CHECK_EQUAL(nData, 7);
 }
 
+BOOST_AUTO_TEST_CASE(PipelinedOutOfOrder)
+{
+  // even segments are delayed, so that Data arrive out of order
+  face2.listen("ndn:/A", [this] (const Name& prefix, const Interest& interest) {
+    ++producerNInterests;
+    uint64_t segment = interest.getName().at(-1).toSegment();
+    Data data(interest.getName());
+    if (segment == 29) {
+      data.setFinalBlockId(interest.getName().at(-1));
+    }
+    time::milliseconds delay(segment % 2 == 0 ? 10 : 1);
+    face2.getScheduler().schedule(delay, [this, interest, data] { face2.reply(interest, data); });
+  });
+
+  bool isSuccess = false;
+  std::vector<uint64_t> segments;
+  producerNInterests = 0;
+
+  requestSegments(face1, "ndn:/A/B/%FD%02", {0, 9999},
+                  [&segments] (const Interest&, Data& data) {
+                    segments.push_back(data.getName().at(-1).toSegment());
+                  },
+                  [this, &isSuccess] { isSuccess = true; io.stop(); },
+                  bind([] { BOOST_ERROR("FAIL"); }),
+                  AutoRetryLimited(3), time::milliseconds(1000), nullptr,
+                  SegmentPipelineFixed(8));
+
+  face1.getScheduler().schedule(time::seconds(2), [this] { io.stop(); });
+  io.run();
+
+  BOOST_CHECK(isSuccess);
+  BOOST_REQUIRE_EQUAL(segments.size(), 30);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    BOOST_CHECK_EQUAL(segments[i], i);
+  }
+  // segments beyond FinalBlockId can be requested before it is known
+  BOOST_CHECK_LE(producerNInterests, 30 + 8);
+}
+
+BOOST_AUTO_TEST_CASE(PipelinedBusy)
+{
+  // first Interest of every fifth segment is Nacked
+  std::set<uint64_t> nackedSegments;
+  face2.listen("ndn:/A", [&] (const Name& prefix, const Interest& interest) {
+    ++producerNInterests;
+    uint64_t segment = interest.getName().at(-1).toSegment();
+    if (segment % 5 == 0 && nackedSegments.insert(segment).second) {
+      face2.reply(interest, Nack(Nack::BUSY, interest));
+      return;
+    }
+    Data data(interest.getName());
+    if (segment == 39) {
+      data.setFinalBlockId(interest.getName().at(-1));
+    }
+    face2.reply(interest, data);
+  });
+
+  bool isSuccess = false;
+  std::vector<uint64_t> segments;
+  producerNInterests = 0;
+
+  requestSegments(face1, "ndn:/A/B/%FD%02", {0, 39},
+                  [&segments] (const Interest&, Data& data) {
+                    segments.push_back(data.getName().at(-1).toSegment());
+                  },
+                  [this, &isSuccess] { isSuccess = true; io.stop(); },
+                  bind([] { BOOST_ERROR("FAIL"); }),
+                  AutoRetryLimited(3), time::milliseconds::min(), nullptr,
+                  SegmentPipelineAimd(4, 16));
+
+  face1.getScheduler().schedule(time::seconds(5), [this] { io.stop(); });
+  io.run();
+
+  BOOST_CHECK(isSuccess);
+  BOOST_REQUIRE_EQUAL(segments.size(), 40);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    BOOST_CHECK_EQUAL(segments[i], i);
+  }
+  BOOST_CHECK_EQUAL(producerNInterests, 40 + 8);
+}
+
+BOOST_AUTO_TEST_CASE(OvershootFinalBlockId)
+{
+  // segment 1 is delayed; Interests beyond FinalBlockId are unanswered
+  face2.listen("ndn:/A", [this] (const Name& prefix, const Interest& interest) {
+    ++producerNInterests;
+    uint64_t segment = interest.getName().at(-1).toSegment();
+    if (segment > 3) {
+      return;
+    }
+    Data data(interest.getName());
+    data.setFinalBlockId(name::Component::fromSegment(3));
+    time::milliseconds delay(segment == 1 ? 50 : 0);
+    face2.getScheduler().schedule(delay, [this, interest, data] { face2.reply(interest, data); });
+  });
+
+  bool isSuccess = false;
+  int nData = 0;
+  producerNInterests = 0;
+
+  requestSegments(face1, "ndn:/A/B/%FD%02", {0, 9999},
+                  bind([&nData] { ++nData; }),
+                  [this, &isSuccess] { isSuccess = true; io.stop(); },
+                  bind([] { BOOST_ERROR("FAIL"); }),
+                  AutoRetryLimited(2), time::milliseconds(1000),
+                  [] (Interest& interest) {
+                    // Interests beyond FinalBlockId time out before segment 1 arrives
+                    if (interest.getName().at(-1).toSegment() > 3) {
+                      interest.setInterestLifetime(time::milliseconds(10));
+                    }
+                  },
+                  SegmentPipelineFixed(8));
+
+  face1.getScheduler().schedule(time::seconds(2), [this] { io.stop(); });
+  io.run();
+
+  BOOST_CHECK(isSuccess);
+  BOOST_CHECK_EQUAL(nData, 4);
+  // Interests beyond FinalBlockId are not retransmitted
+  BOOST_CHECK_EQUAL(producerNInterests, 8);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -0,0 +1,55 @@
+#include "util/rtt-estimator.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+using ndn::util::RttEstimator;
+
+BOOST_AUTO_TEST_SUITE(TestRttEstimator)
+
+BOOST_AUTO_TEST_CASE(Rfc6298)
+{
+  RttEstimator rtt;
+  rtt.minRto = time::milliseconds(1);
+  BOOST_CHECK(!rtt.hasMeasurement());
+  BOOST_CHECK(rtt.getRto() == time::seconds(1));
+
+  rtt.addMeasurement(time::milliseconds(80));
+  BOOST_CHECK(rtt.getSrtt() == time::milliseconds(80));
+  BOOST_CHECK(rtt.getRttVar() == time::milliseconds(40));
+  BOOST_CHECK(rtt.getRto() == time::milliseconds(240));
+
+  rtt.addMeasurement(time::milliseconds(160));
+  // RTTVAR = 3/4 * 40 + 1/4 * |80 - 160| = 50
+  // SRTT = 7/8 * 80 + 1/8 * 160 = 90
+  BOOST_CHECK(rtt.getRttVar() == time::milliseconds(50));
+  BOOST_CHECK(rtt.getSrtt() == time::milliseconds(90));
+  BOOST_CHECK(rtt.getRto() == time::milliseconds(290));
+  BOOST_CHECK_EQUAL(rtt.getNMeasurements(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Bounds)
+{
+  RttEstimator rtt;
+  rtt.minRto = time::milliseconds(200);
+  rtt.maxRto = time::seconds(2);
+
+  rtt.addMeasurement(time::milliseconds(1));
+  BOOST_CHECK(rtt.getRto() == time::milliseconds(200));
+
+  BOOST_CHECK(rtt.getBackoffRto(1) == time::milliseconds(200));
+  BOOST_CHECK(rtt.getBackoffRto(2) == time::milliseconds(400));
+  BOOST_CHECK(rtt.getBackoffRto(4) == time::milliseconds(1600));
+  BOOST_CHECK(rtt.getBackoffRto(5) == time::seconds(2));
+  BOOST_CHECK(rtt.getBackoffRto(100) == time::seconds(2));
+
+  rtt.addMeasurement(time::seconds(10));
+  BOOST_CHECK(rtt.getRto() == time::seconds(2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
@@ -0,0 +1,97 @@
+#include "util/timing-wheel-scheduler.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace tests {
+
+using ndn::util::TimingWheelScheduler;
+using ndn::util::SchedulerEventId;
+
+BOOST_AUTO_TEST_SUITE(TestTimingWheelScheduler)
+
+BOOST_AUTO_TEST_CASE(ScheduleCancel)
+{
+  boost::asio::io_service io;
+  TimingWheelScheduler scheduler(io);
+
+  std::vector<int> fired;
+  scheduler.schedule(time::milliseconds(30), [&fired] { fired.push_back(30); });
+  scheduler.schedule(time::milliseconds(2), [&fired] { fired.push_back(2); });
+  SchedulerEventId cancelled = scheduler.schedule(time::milliseconds(10),
+                                                  [&fired] { fired.push_back(10); });
+  // beyond first level of the wheel
+  scheduler.schedule(time::milliseconds(300), [&fired] { fired.push_back(300); });
+  scheduler.cancel(cancelled);
+  BOOST_CHECK_EQUAL(scheduler.size(), 3);
+
+  time::steady_clock::TimePoint start = time::steady_clock::now();
+  io.run();
+  BOOST_CHECK(time::steady_clock::now() - start >= time::milliseconds(300));
+
+  BOOST_CHECK((fired == std::vector<int>{2, 30, 300}));
+  BOOST_CHECK_EQUAL(scheduler.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Reschedule)
+{
+  boost::asio::io_service io;
+  TimingWheelScheduler scheduler(io);
+
+  int nFired = 0;
+  std::function<void()> f = [&] {
+    if (++nFired < 20) {
+      scheduler.schedule(time::milliseconds(1), f);
+    }
+  };
+  scheduler.schedule(time::milliseconds(1), f);
+  size_t capacity = scheduler.getCapacity();
+  io.run();
+
+  BOOST_CHECK_EQUAL(nFired, 20);
+  // timer objects are recycled
+  BOOST_CHECK_EQUAL(scheduler.getCapacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(HeldEventIds)
+{
+  boost::asio::io_service io;
+  SchedulerEventId outliving;
+  {
+    TimingWheelScheduler scheduler(io);
+
+    // EventIds are held until after the events finish, as PIT entries do
+    std::vector<SchedulerEventId> ids(3000);
+    size_t capacity = 0;
+    for (int round = 0; round < 3; ++round) {
+      for (SchedulerEventId& id : ids) {
+        id = scheduler.schedule(time::milliseconds(2), [] {});
+      }
+      for (size_t i = 0; i < ids.size(); i += 2) {
+        scheduler.cancel(ids[i]);
+      }
+      io.run();
+      io.reset();
+      for (SchedulerEventId& id : ids) {
+        id.reset();
+      }
+
+      if (round == 0) {
+        capacity = scheduler.getCapacity();
+      }
+      else {
+        // timers are recycled when their EventIds are released
+        BOOST_CHECK_EQUAL(scheduler.getCapacity(), capacity);
+      }
+    }
+
+    outliving = scheduler.schedule(time::seconds(10), [] {});
+  }
+  // EventId can be released after scheduler is destructed
+  outliving.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndn
@@ -0,0 +1,34 @@
+/**
+ *  face-trace-decode converts a binary trace file written by BinaryFaceTraceWriter
+ *  into the text format of FaceTraceWriter.
+ */
+
+#include "util/binary-face-trace-writer.hpp"
+
+namespace ndn {
+namespace face_trace_decode {
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 2) {
+    std::cerr << "USAGE: ./face-trace-decode trace.bin" << std::endl;
+    return 1;
+  }
+
+  std::ifstream input(argv[1], std::ios::binary);
+  if (!util::decodeBinaryFaceTrace(input, std::cout)) {
+    std::cerr << "bad input" << std::endl;
+    return 2;
+  }
+  return 0;
+}
+
+} // namespace face_trace_decode
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::face_trace_decode::main(argc, argv);
+}
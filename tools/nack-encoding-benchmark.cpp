@@ -0,0 +1,117 @@
+/**
+ *  nack-encoding-benchmark compares name-based NACK encoding with LpPacket encoding.
+ *
+ *  For each encoding, it measures the time to encode a NACK into wire format,
+ *  and the time for a receiver to classify and decode that wire format,
+ *  in the same way as ClientFace::receiveElement.
+ *
+ *  Usage: nack-encoding-benchmark [nIterations]
+ */
+
+#include "nack.hpp"
+#include <boost/lexical_cast.hpp>
+
+namespace ndn {
+namespace nack_encoding_benchmark {
+
+static void
+report(const std::string& title, const time::steady_clock::Duration& duration, size_t n)
+{
+  std::cout << title << " "
+            << time::duration_cast<time::nanoseconds>(duration).count() / n << "ns/op" << std::endl;
+}
+
+static Interest
+makeInterest()
+{
+  Interest interest(Name("ndn:/example/nfs/home/u1/file.txt").appendVersion(1).appendSegment(7));
+  interest.setMustBeFresh(true);
+  interest.setMaxSuffixComponents(1);
+  interest.setNonce(0x12345678);
+  return interest;
+}
+
+static void
+benchmarkNameBased(size_t n)
+{
+  Nack nack(Nack::BUSY, makeInterest());
+  Block wire;
+
+  time::steady_clock::TimePoint t0 = time::steady_clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    wire = nack.encode().wireEncode();
+  }
+  time::steady_clock::TimePoint t1 = time::steady_clock::now();
+  report("name-based encode", t1 - t0, n);
+
+  auto buffer = make_shared<Buffer>(wire.wire(), wire.size());
+
+  size_t nDecoded = 0;
+  time::steady_clock::TimePoint t2 = time::steady_clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    // a received packet is parsed afresh each time
+    Block received(buffer);
+    if (received.type() == tlv::Interest) {
+      Interest interest(received);
+      Nack decoded;
+      nDecoded += decoded.decode(interest);
+    }
+  }
+  time::steady_clock::TimePoint t3 = time::steady_clock::now();
+  BOOST_ASSERT(nDecoded == n);
+  report("name-based decode", t3 - t2, n);
+}
+
+static void
+benchmarkLp(size_t n)
+{
+  Nack nack(Nack::BUSY, makeInterest());
+  const Block& payload = nack.getInterest().wireEncode();
+  Block header;
+
+  time::steady_clock::TimePoint t0 = time::steady_clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    header = nack.encodeLpHeader();
+  }
+  time::steady_clock::TimePoint t1 = time::steady_clock::now();
+  report("LpPacket encode (header only, sent with payload)", t1 - t0, n);
+
+  auto buffer = make_shared<Buffer>(header.wire(), header.size());
+  buffer->insert(buffer->end(), payload.wire(), payload.wire() + payload.size());
+
+  size_t nDecoded = 0;
+  time::steady_clock::TimePoint t2 = time::steady_clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    // a received packet is parsed afresh each time
+    Block received(buffer);
+    if (received.type() == Nack::TLV_LP_PACKET) {
+      Nack decoded;
+      nDecoded += decoded.decodeLp(received);
+    }
+  }
+  time::steady_clock::TimePoint t3 = time::steady_clock::now();
+  BOOST_ASSERT(nDecoded == n);
+  report("LpPacket decode", t3 - t2, n);
+}
+
+int
+main(int argc, char* argv[])
+{
+  size_t n = 1000000;
+  if (argc > 1) {
+    n = boost::lexical_cast<size_t>(argv[1]);
+  }
+
+  benchmarkNameBased(n);
+  benchmarkLp(n);
+  return 0;
+}
+
+} // namespace nack_encoding_benchmark
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::nack_encoding_benchmark::main(argc, argv);
+}
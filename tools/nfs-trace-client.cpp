@@ -1,10 +1,13 @@
 #include "standalone-client-face.hpp"
 #include "nfs-trace-common.hpp"
-#include <unordered_set>
+#include "nfs-trace-ops.hpp"
 #include <unordered_map>
+#include <fstream>
 #include <ndn-cxx/util/signal.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include "util/request-segments.hpp"
 #include "util/face-trace-writer.hpp"
+#include "util/logger.hpp"
 
 namespace ndn {
 namespace nfs_trace {
@@ -12,166 +15,12 @@ namespace nfs_trace {
 using ndn::util::signal::Signal;
 using ndn::util::requestSegments;
 using ndn::util::AutoRetryLimited;
+using ndn::util::SegmentPipelineAimd;
 
 // use system_clock so that logs can be correlated across machines
 typedef time::system_clock EmulationClock;
 typedef EmulationClock::TimePoint EmulationTime;
 
-enum NfsProc {
-  NFS_NONE,
-  NFS_GETATTR,
-  NFS_LOOKUP,
-  NFS_ACCESS,
-  NFS_READLINK,
-  NFS_READ,
-  NFS_WRITE,
-  NFS_READDIRP,
-  NFS_SETATTR,
-  NFS_CREATE,
-  NFS_MKDIR,
-  NFS_SYMLINK,
-  NFS_REMOVE,
-  NFS_RMDIR,
-  NFS_RENAME
-};
-
-static std::vector<std::string> NfsProcStrings = {
-  "none",
-  "getattr",
-  "lookup",
-  "access",
-  "readlink",
-  "read",
-  "write",
-  "readdirp",
-  "setattr",
-  "create",
-  "mkdir",
-  "symlink",
-  "remove",
-  "rmdir",
-  "rename"
-};
-
-NfsProc
-parseNfsProc(const std::string& s)
-{
-  auto it = std::find(NfsProcStrings.begin(), NfsProcStrings.end(), s);
-  if (it != NfsProcStrings.end()) {
-    return static_cast<NfsProc>(it - NfsProcStrings.begin());
-  }
-  return NFS_NONE;
-}
-
-typedef uint64_t NfsTimestamp; // microseconds from epoch
-
-NfsTimestamp
-parseNfsTimestamp(const std::string& s)
-{
-  double d = boost::lexical_cast<double>(s);
-  return static_cast<NfsTimestamp>(d * 1000000);
-}
-
-struct NfsOp
-{
-  NfsTimestamp timestamp;
-  NfsProc proc;
-  std::string path;
-  uint64_t version;
-  uint64_t segStart;
-  uint64_t nSegments;
-};
-
-std::ostream&
-operator<<(std::ostream& os, const NfsOp& op)
-{
-  os << op.timestamp << ','
-     << NfsProcStrings[op.proc] << ','
-     << op.path << ','
-     << op.version << ','
-     << op.segStart << ','
-     << op.nSegments;
-  return os;
-}
-
-/** \brief parses .ops trace file
- */
-class OpsParser : noncopyable
-{
-public:
-  explicit
-  OpsParser(std::istream& is);
-
-  NfsOp
-  read();
-
-public:
-  std::function<bool(const NfsTimestamp&)> acceptTimestamp;
-
-private:
-  std::istream& m_is;
-};
-
-OpsParser::OpsParser(std::istream& is)
-  : acceptTimestamp(bind([] { return true; }))
-  , m_is(is)
-{
-}
-
-NfsOp
-OpsParser::read()
-{
-  while (true) {
-    NfsOp op = {NfsTimestamp(), NFS_NONE, "", 0, 0, 0};
-    if (m_is.eof()) {
-      return op;
-    }
-
-    static std::string line;
-    std::getline(m_is, line);
-
-    size_t pos1 = line.find(','),
-           pos2 = line.find(',', pos1 + 1),
-           pos3 = line.find(',', pos2 + 1),
-           pos4 = line.find(',', pos3 + 1),
-           pos5 = line.find(',', pos4 + 1);
-    if (pos1 == std::string::npos ||
-        pos2 == std::string::npos ||
-        pos3 == std::string::npos ||
-        pos4 == std::string::npos ||
-        pos5 == std::string::npos) {
-      continue; // bad input line
-    }
-
-    op.timestamp = parseNfsTimestamp(line.substr(0, pos1));
-    if (!acceptTimestamp(op.timestamp)) {
-      continue;
-    }
-
-    op.proc = parseNfsProc(line.substr(pos1 + 1, pos2 - pos1 - 1));
-    if (op.proc == NFS_NONE) {
-      continue; // bad input line
-    }
-
-    op.path = line.substr(pos2 + 1, pos3 - pos2 - 1);
-
-    if (op.proc == NFS_READ || op.proc == NFS_WRITE || op.proc == NFS_READDIRP) {
-      op.version = parseNfsTimestamp(line.substr(pos3 + 1, pos4 - pos3 - 1));
-      op.segStart = boost::lexical_cast<uint64_t>(line.substr(pos4 + 1, pos5 - pos4 - 1));
-      op.nSegments = boost::lexical_cast<uint64_t>(line.substr(pos5 + 1));
-    }
-
-    if (op.version == 0) {
-      // TODO reprocess the trace for accurate ctime or mtime
-      op.version = op.timestamp;
-    }
-
-    return op;
-  }
-  BOOST_ASSERT(false);
-  return {NfsTimestamp(), NFS_NONE, "", 0, 0, 0};
-}
-
 class Client : noncopyable
 {
 public:
@@ -234,7 +83,8 @@ private: // WRITE
   void
   finishWrite(const Name& fetchPrefix);
 
-  /** \brief fail WRITEs where no fetch Interest has been received within FETCH_MAX_GAP
+  /** \brief fail WRITEs where no fetch Interest has been received within FETCH_MAX_GAP,
+   *         and forget WRITEs completed more than FETCH_MAX_GAP ago
    */
   void
   expireWrites();
@@ -250,7 +100,9 @@ private:
   Name m_clientPrefix;
   uint8_t m_payloadBuffer[ndn::MAX_NDN_PACKET_SIZE];
   std::unordered_map<Name, WriteProcess> m_writes;
-  std::unordered_set<Name> m_completedWrites;
+  /** \brief completion time of recent WRITEs, whose Data may be fetched again
+   */
+  std::unordered_map<Name, EmulationTime> m_completedWrites;
   static const int SEGMENT_SIZE = 4096;
   static const int DIR_PER_SEGMENT = 32;
   static const EmulationClock::Duration FETCH_MAX_GAP;
@@ -383,7 +235,8 @@ Client::startRead(const NfsOp& op)
                   AutoRetryLimited(AUTO_RETRY_LIMIT), AUTO_RETRY_RETX_INTERVAL,
                   [] (Interest& interest) {
                     interest.setExclude(ServerAction{SA_READ, 0, SEGMENT_SIZE});
-                  });
+                  },
+                  SegmentPipelineAimd());
 }
 
 void
@@ -465,9 +318,7 @@ Client::processFetchInterest(const Interest& interest, const ServerAction& sa)
   if (it == m_writes.end()) { // not a WRITE in progress
 
     if (m_completedWrites.count(fetchPrefix) > 0) {
-      // It's necessary to keep m_completedWrites in order to answer Interests from NFS server
-      // for Data previously lost one client-switch link.
-      // XXX m_completedWrites grows indefinitely, but this won't be a problem for short traces.
+      // NFS server may retransmit a fetch Interest whose Data was lost on client-switch link
       this->sendFetchReply(interest);
       return;
     }
@@ -507,7 +358,7 @@ Client::finishWrite(const Name& fetchPrefix)
   NfsOp op = wp.op;
   EmulationTime wpStart = wp.start;
   m_writes.erase(it);
-  m_completedWrites.insert(fetchPrefix);
+  m_completedWrites[fetchPrefix] = EmulationClock::now();
 
   std::stringstream params;
   params << m_clientHost << ':' << op.version << ':'
@@ -536,16 +387,84 @@ Client::expireWrites()
       ++it;
     }
   }
+
+  // like a WRITE in progress, a completed WRITE is not expected to be fetched after FETCH_MAX_GAP
+  for (auto it = m_completedWrites.begin(); it != m_completedWrites.end();) {
+    if (it->second < minLastFetch) {
+      it = m_completedWrites.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+/** \brief maps trace time to emulation time
+ *
+ *  Operations with timestamp in [begin,end) are replayed. Trace time \p begin is mapped to
+ *  the start of emulation, and trace time elapses \p speed times as fast as emulation time:
+ *  speed 10 replays ten minutes of trace in one minute, and speed 0.5 replays it in twenty.
+ */
+struct ReplayTimeScale
+{
+  double speed;
+  NfsTimestamp begin;
+  NfsTimestamp end;
+
+  ReplayTimeScale()
+    : speed(1.0)
+    , begin(0)
+    , end(std::numeric_limits<NfsTimestamp>::max())
+  {
+  }
+
+  /** \return emulation time since start of emulation, at which trace time \p t is replayed
+   */
+  EmulationClock::Duration
+  toEmulationDuration(NfsTimestamp t) const
+  {
+    BOOST_ASSERT(speed > 0.0);
+    double traceTime = t >= begin ? static_cast<double>(t - begin) :
+                                    -static_cast<double>(begin - t);
+    return time::microseconds(static_cast<time::microseconds::rep>(traceTime / speed));
+  }
+};
+
+inline std::ostream&
+operator<<(std::ostream& os, const ReplayTimeScale& scale)
+{
+  os << "speed=" << scale.speed << " begin=" << scale.begin;
+  if (scale.end != std::numeric_limits<NfsTimestamp>::max()) {
+    os << " end=" << scale.end;
+  }
+  return os;
 }
 
 /** \brief drives an emulation session
+ *
+ *  A session may have several clients, each serving one or more client-ids.
+ *  An operation with a client-id goes to the client of that client-id.
+ *  An operation without client-id goes to client-id hashNfsPath(path) modulo nPathPartitions,
+ *  so that operations on same path stay on one client.
+ *  Each client has its own log stream, whose content is same as a session of that client alone.
  */
 class EmulationRunner : noncopyable
 {
 public:
-  EmulationRunner(OpsParser& trace, Client& client,
+  EmulationRunner(OpsReader& trace, boost::asio::io_service& io);
+
+  /** \brief constructs a session with one client, which serves every client-id
+   */
+  EmulationRunner(OpsReader& trace, Client& client,
                   boost::asio::io_service& io, std::ostream& log);
 
+  /** \brief lets \p client serve \p clientId, and log its operations to \p log
+   *
+   *  A client may serve several client-ids; its log stream is given by the first call.
+   */
+  void
+  addClient(uint32_t clientId, Client& client, std::ostream& log);
+
   /** \brief start replaying the trace
    */
   void
@@ -553,6 +472,23 @@ public:
 
   Signal<EmulationRunner> onFinish;
 
+public:
+  /** \brief replay speed and window of trace time
+   *  \pre changed before start() is invoked
+   */
+  ReplayTimeScale timeScale;
+
+  /** \brief number of client-ids among which operations without client-id are distributed
+   */
+  uint32_t nPathPartitions;
+
+  /** \brief invoked upon first operation of a client-id that has no client
+   *
+   *  It should create a client and add it with addClient(clientId, ...).
+   *  If no client is added, operations of that client-id are skipped.
+   */
+  std::function<void(uint32_t clientId)> makeClient;
+
 private:
   EmulationTime
   computeEmulationTime(NfsTimestamp nfsTime) const;
@@ -560,6 +496,20 @@ private:
   void
   run();
 
+  /** \return index in m_clients of the client of \p op, or NO_CLIENT
+   */
+  size_t
+  findClient(const NfsOp& op);
+
+  /** \brief writes speed and window of replay to a client log, before any operation
+   */
+  void
+  logHeader(std::ostream& log) const;
+
+  void
+  logOpResult(size_t clientIndex, const NfsOp& op, const char* result,
+              const EmulationTime& start, const EmulationTime& end);
+
   /** \brief no more operations
    */
   void
@@ -570,9 +520,17 @@ private:
 
 private:
   boost::asio::io_service& m_io;
-  OpsParser& m_trace;
-  Client& m_client;
-  std::ostream& m_log;
+  OpsReader& m_trace;
+
+  struct ClientSlot
+  {
+    Client* client;
+    std::ostream* log;
+    int nPendings;
+  };
+  std::vector<ClientSlot> m_clients;
+  std::unordered_map<uint32_t, size_t> m_clientIndex; ///< client-id => index in m_clients
+  static const size_t NO_CLIENT;
 
   Scheduler m_scheduler;
   EventId m_periodicalCleanup;
@@ -583,55 +541,97 @@ private:
   EmulationTime m_startEmulationTime;
 
   NfsOp m_nextOp;
+  size_t m_nextClient;
   bool m_isInputEnded;
   int m_pendings;
 };
 const EmulationClock::Duration EmulationRunner::CLEANUP_INTERVAL = time::seconds(10);
 const EmulationClock::Duration EmulationRunner::WAIT_AFTER_LAST_OP = time::seconds(20);
+const size_t EmulationRunner::NO_CLIENT = std::numeric_limits<size_t>::max();
 
-EmulationRunner::EmulationRunner(OpsParser& trace, Client& client,
-                                 boost::asio::io_service& io, std::ostream& log)
-  : m_io(io)
+EmulationRunner::EmulationRunner(OpsReader& trace, boost::asio::io_service& io)
+  : nPathPartitions(1)
+  , m_io(io)
   , m_trace(trace)
-  , m_client(client)
-  , m_log(log)
   , m_scheduler(io)
   , m_isStarted(false)
+  , m_nextClient(NO_CLIENT)
   , m_isInputEnded(false)
   , m_pendings(0)
 {
-  m_client.opSuccess.connect([this] (const NfsOp& op,
-                                     const EmulationTime& start, const EmulationTime& end) {
-    BOOST_ASSERT(op.proc != NFS_NONE);
-    m_log << op << ','
-          << "SUCCESS" << ','
-          << time::duration_cast<time::microseconds>(start.time_since_epoch()).count() << ','
-          << time::duration_cast<time::microseconds>(end.time_since_epoch()).count() << ','
-          << time::duration_cast<time::microseconds>(end - start).count() << std::endl;
-    if (--m_pendings == 0 && m_isInputEnded) {
-      this->finish();
-    }
+}
+
+EmulationRunner::EmulationRunner(OpsReader& trace, Client& client,
+                                 boost::asio::io_service& io, std::ostream& log)
+  : EmulationRunner(trace, io)
+{
+  makeClient = [this, &client, &log] (uint32_t clientId) {
+    this->addClient(clientId, client, log);
+  };
+}
+
+void
+EmulationRunner::addClient(uint32_t clientId, Client& client, std::ostream& log)
+{
+  auto existing = std::find_if(m_clients.begin(), m_clients.end(),
+                               [&client] (const ClientSlot& slot) { return slot.client == &client; });
+  if (existing != m_clients.end()) {
+    m_clientIndex[clientId] = existing - m_clients.begin();
+    return;
+  }
+
+  size_t index = m_clients.size();
+  m_clients.push_back({&client, &log, 0});
+  m_clientIndex[clientId] = index;
+  if (m_isStarted) {
+    this->logHeader(log);
+  }
+
+  client.opSuccess.connect([this, index] (const NfsOp& op,
+                                          const EmulationTime& start, const EmulationTime& end) {
+    this->logOpResult(index, op, "SUCCESS", start, end);
   });
-  m_client.opFailure.connect([this] (const NfsOp& op,
-                                     const EmulationTime& start, const EmulationTime& end) {
-    BOOST_ASSERT(op.proc != NFS_NONE);
-    m_log << op << ','
-          << "FAILURE" << ','
-          << time::duration_cast<time::microseconds>(start.time_since_epoch()).count() << ','
-          << time::duration_cast<time::microseconds>(end.time_since_epoch()).count() << ','
-          << time::duration_cast<time::microseconds>(end - start).count() << std::endl;
-    if (--m_pendings == 0 && m_isInputEnded) {
-      this->finish();
-    }
+  client.opFailure.connect([this, index] (const NfsOp& op,
+                                          const EmulationTime& start, const EmulationTime& end) {
+    this->logOpResult(index, op, "FAILURE", start, end);
   });
 }
 
+void
+EmulationRunner::logOpResult(size_t clientIndex, const NfsOp& op, const char* result,
+                             const EmulationTime& start, const EmulationTime& end)
+{
+  BOOST_ASSERT(op.proc != NFS_NONE);
+  ClientSlot& slot = m_clients[clientIndex];
+  *slot.log << op << ','
+            << result << ','
+            << time::duration_cast<time::microseconds>(start.time_since_epoch()).count() << ','
+            << time::duration_cast<time::microseconds>(end.time_since_epoch()).count() << ','
+            << time::duration_cast<time::microseconds>(end - start).count() << std::endl;
+  --slot.nPendings;
+  if (--m_pendings == 0 && m_isInputEnded) {
+    this->finish();
+  }
+}
+
 void
 EmulationRunner::start()
 {
   BOOST_ASSERT(!m_isStarted);
+  BOOST_ASSERT(nPathPartitions > 0);
   m_isStarted = true;
 
+  // skip operations before the window without fully parsing them
+  NfsTimestamp begin = timeScale.begin;
+  auto accept = m_trace.acceptTimestamp;
+  m_trace.acceptTimestamp = [begin, accept] (const NfsTimestamp& ts) {
+    return ts >= begin && accept(ts);
+  };
+
+  LOG("replay " << timeScale);
+  for (ClientSlot& slot : m_clients) {
+    this->logHeader(*slot.log);
+  }
   m_startEmulationTime = EmulationClock::now();
 
   this->periodicalCleanupThenReschedule();
@@ -642,7 +642,7 @@ EmulationRunner::start()
 EmulationTime
 EmulationRunner::computeEmulationTime(NfsTimestamp nfsTime) const
 {
-  return m_startEmulationTime + time::microseconds(nfsTime);
+  return m_startEmulationTime + timeScale.toEmulationDuration(nfsTime);
 }
 
 void
@@ -650,38 +650,66 @@ EmulationRunner::run()
 {
   while (true) {
     m_nextOp = m_trace.read();
-    if (m_nextOp.proc == NFS_NONE) {
+    // trace is in time order, so no operation after the window needs to be read
+    if (m_nextOp.proc == NFS_NONE || m_nextOp.timestamp >= timeScale.end) {
       m_isInputEnded = true;
       if (m_pendings == 0) {
         this->finish();
       }
       return;
     }
-    if (m_client.isIgnored(m_nextOp)) {
+    m_nextClient = this->findClient(m_nextOp);
+    if (m_nextClient == NO_CLIENT) {
+      continue;
+    }
+    ClientSlot& slot = m_clients[m_nextClient];
+    if (slot.client->isIgnored(m_nextOp)) {
       continue;
     }
 
     EmulationClock::Duration slack = this->computeEmulationTime(m_nextOp.timestamp) -
                                      EmulationClock::now();
     ++m_pendings;
+    ++slot.nPendings;
 
-    m_log << m_nextOp << ','
-          << "SCHED" << ','
-          << "slack=" << time::duration_cast<time::microseconds>(slack).count() << ','
-          << "pendings=" << m_pendings << ','
-          << std::endl;
+    *slot.log << m_nextOp << ','
+              << "SCHED" << ','
+              << "slack=" << time::duration_cast<time::microseconds>(slack).count() << ','
+              << "pendings=" << slot.nPendings << ','
+              << std::endl;
 
     if (slack > EmulationClock::Duration::zero()) {
       m_scheduler.scheduleEvent(slack, [this] {
-        m_client.startOp(m_nextOp);
+        m_clients[m_nextClient].client->startOp(m_nextOp);
         this->run();
       });
       return;
     }
     else {
-      m_client.startOp(m_nextOp);
+      slot.client->startOp(m_nextOp);
+    }
+  }
+}
+
+size_t
+EmulationRunner::findClient(const NfsOp& op)
+{
+  uint32_t clientId = op.hasClientId ? op.clientKey : op.clientKey % nPathPartitions;
+  auto it = m_clientIndex.find(clientId);
+  if (it == m_clientIndex.end()) {
+    if (makeClient) {
+      makeClient(clientId);
     }
+    // if makeClient did not add a client, remember that this client-id has none
+    it = m_clientIndex.insert({clientId, NO_CLIENT}).first;
   }
+  return it->second;
+}
+
+void
+EmulationRunner::logHeader(std::ostream& log) const
+{
+  log << "# replay " << timeScale << std::endl;
 }
 
 void
@@ -689,7 +717,9 @@ EmulationRunner::finish()
 {
   m_scheduler.cancelEvent(m_periodicalCleanup);
   m_scheduler.scheduleEvent(WAIT_AFTER_LAST_OP, [this] {
-    m_client.periodicalCleanup();
+    for (ClientSlot& slot : m_clients) {
+      slot.client->periodicalCleanup();
+    }
     onFinish();
   });
 }
@@ -697,26 +727,134 @@ EmulationRunner::finish()
 void
 EmulationRunner::periodicalCleanupThenReschedule()
 {
-  m_client.periodicalCleanup();
+  for (ClientSlot& slot : m_clients) {
+    slot.client->periodicalCleanup();
+  }
   m_periodicalCleanup = m_scheduler.scheduleEvent(CLEANUP_INTERVAL,
       bind(&EmulationRunner::periodicalCleanupThenReschedule, this));
 }
 
+/** \return host prefix of the virtual client of \p clientId
+ *
+ *  It is under \p clientHost, so that the route toward \p clientHost
+ *  also delivers FETCH Interests to every virtual client.
+ */
+inline Name
+makeVirtualClientHost(const Name& clientHost, uint32_t clientId)
+{
+  return Name(clientHost).append(std::to_string(clientId));
+}
+
 int
 client_main(int argc, char* argv[])
 {
-  // argv: client-name
+  // argv: client-name [trace-file]
+  // trace is read from stdin if trace-file is omitted
+
+  bool isMultiClient = getenv("NFS_CLIENTS") != nullptr;
+  uint32_t nPathPartitions = 1;
+  if (isMultiClient) {
+    nPathPartitions = std::max(boost::lexical_cast<uint32_t>(getenv("NFS_CLIENTS")), 1U);
+  }
+  size_t nFaces = 1;
+  if (isMultiClient && getenv("NFS_CLIENT_FACES") != nullptr) {
+    nFaces = std::max(boost::lexical_cast<size_t>(getenv("NFS_CLIENT_FACES")), static_cast<size_t>(1));
+  }
+  std::string logDir = ".";
+  if (getenv("NFS_CLIENT_LOG_DIR") != nullptr) {
+    logDir = getenv("NFS_CLIENT_LOG_DIR");
+  }
+  ReplayTimeScale timeScale;
+  if (getenv("NFS_REPLAY_SPEED") != nullptr) {
+    timeScale.speed = boost::lexical_cast<double>(getenv("NFS_REPLAY_SPEED"));
+    if (!(timeScale.speed > 0.0)) {
+      std::cerr << "NFS_REPLAY_SPEED must be positive" << std::endl;
+      return 1;
+    }
+  }
+  if (getenv("NFS_REPLAY_BEGIN") != nullptr) {
+    timeScale.begin = parseNfsTimestamp(getenv("NFS_REPLAY_BEGIN"));
+  }
+  if (getenv("NFS_REPLAY_END") != nullptr) {
+    timeScale.end = parseNfsTimestamp(getenv("NFS_REPLAY_END"));
+  }
 
   boost::asio::io_service io;
-  StandaloneClientFace face(io);
-  face.shouldNackUnmatchedInterest = true;
-  util::FaceTraceWriter::connect(face);
+  std::vector<unique_ptr<StandaloneClientFace>> faces;
+  std::vector<unique_ptr<util::BinaryFaceTraceWriter>> traceWriters;
+  for (size_t i = 0; i < nFaces; ++i) {
+    faces.emplace_back(new StandaloneClientFace(io));
+    StandaloneClientFace& face = *faces.back();
+    face.shouldNackUnmatchedInterest = true;
+    face.shouldAggregateInterests = getenv("NFS_AGGREGATE_INTERESTS") != nullptr;
+    if (getenv("NFS_RATE_CONTROL") != nullptr) {
+      face.getRateController().enable("ndn:/NFS");
+    }
+    if (getenv("NFS_REPLY_CACHE_MB") != nullptr) {
+      face.getReplyCache().setCapacity(
+        boost::lexical_cast<size_t>(getenv("NFS_REPLY_CACHE_MB")) * 1024 * 1024);
+    }
+    traceWriters.push_back(enableFaceTrace(face, nFaces > 1 ? "." + std::to_string(i) : ""));
+  }
 
-  OpsParser trace(std::cin);
-  Client client(face, "ndn:/NFS", std::string("ndn:/") + argv[1]);
+  unique_ptr<OpsReader> trace;
+  if (argc > 2 && boost::algorithm::ends_with(argv[2], ".opsbin")) {
+    OpsBinReader* reader = new OpsBinReader(argv[2]);
+    trace.reset(reader);
+    if (!reader->isValid()) {
+      std::cerr << argv[2] << " is not a valid .opsbin file" << std::endl;
+      return 1;
+    }
+  }
+  else if (argc > 2) {
+    trace.reset(new MappedOpsParser(argv[2]));
+  }
+  else {
+    trace.reset(new OpsParser(std::cin));
+  }
+
+  // with one client, the log is written to stdout;
+  // otherwise, each client-id has a client named {client-host}/{client-id}, logged to
+  // {client-host}-{client-id}.log, which is created upon first operation,
+  // and the i-th created client uses face i%nFaces
+  std::vector<unique_ptr<Client>> clients;
+  std::vector<unique_ptr<std::ofstream>> logs;
+  EmulationRunner runner(*trace, io);
+  runner.timeScale = timeScale;
+  runner.nPathPartitions = nPathPartitions;
+  if (!isMultiClient) {
+    clients.emplace_back(new Client(*faces.front(), "ndn:/NFS", "ndn:/" + std::string(argv[1])));
+    Client& client = *clients.back();
+    runner.makeClient = [&runner, &client] (uint32_t clientId) {
+      runner.addClient(clientId, client, std::cout);
+    };
+  }
+  else {
+    runner.makeClient = [&] (uint32_t clientId) {
+      std::string logName = std::string(argv[1]) + "-" + std::to_string(clientId);
+      unique_ptr<std::ofstream> log(new std::ofstream(logDir + "/" + logName + ".log"));
+      if (!*log) {
+        std::cerr << "cannot open log file for " << logName << std::endl;
+        return;
+      }
+      clients.emplace_back(new Client(*faces[clients.size() % nFaces], "ndn:/NFS",
+                                      makeVirtualClientHost("ndn:/" + std::string(argv[1]),
+                                                            clientId)));
+      logs.push_back(std::move(log));
+      runner.addClient(clientId, *clients.back(), *logs.back());
+    };
+  }
 
-  EmulationRunner runner(trace, client, io, std::cout);
   runner.onFinish.connect([&] {
+    LOG("clients=" << clients.size() << " faces=" << nFaces);
+    for (size_t i = 0; i < nFaces; ++i) {
+      const ClientFace::RequestCounters& cnt = faces[i]->getRequestCounters();
+      LOG("face=" << i << " requests=" << cnt.nRequests << " aggregated=" << cnt.nAggregated);
+      for (const RateController::Flow& flow : faces[i]->getRateController()) {
+        LOG("face=" << i << " flow=" << flow.prefix << " cwnd=" << flow.cwnd <<
+            " queued=" << flow.nQueued << " congestion-signals=" << flow.nCongestionSignals);
+      }
+    }
     io.stop();
   });
   runner.start();
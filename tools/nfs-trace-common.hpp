@@ -2,6 +2,9 @@
 #define NDNCXXEXT_TOOLS_NFS_TRACE_COMMON_HPP
 
 #include "common.hpp"
+#include "util/face-trace-writer.hpp"
+#include "util/binary-face-trace-writer.hpp"
+#include "util/request-auto-retry.hpp"
 #include <sstream>
 #include <boost/lexical_cast.hpp>
 
@@ -158,8 +161,30 @@ stripSignature(const Name& name)
   return name.getPrefix(-ndn::signed_interest::MIN_LENGTH);
 }
 
+/** \brief enables face trace
+ *
+ *  If FACE_TRACE_FILE environment variable is set, binary trace is written to that file,
+ *  to be decoded with face-trace-decode; otherwise, text trace is logged.
+ *  \param fileSuffix appended to the trace file name, so that faces in one process
+ *                    write separate files
+ */
+inline unique_ptr<util::BinaryFaceTraceWriter>
+enableFaceTrace(ClientFace& face, const std::string& fileSuffix = "")
+{
+  unique_ptr<util::BinaryFaceTraceWriter> writer;
+  const char* traceFile = getenv("FACE_TRACE_FILE");
+  if (traceFile != nullptr && traceFile[0] != '\0') {
+    writer.reset(new util::BinaryFaceTraceWriter(std::string(traceFile) + fileSuffix));
+    writer->connect(face);
+  }
+  else {
+    util::FaceTraceWriter::connect(face);
+  }
+  return writer;
+}
+
 static const int AUTO_RETRY_LIMIT = 10;
-static const time::milliseconds AUTO_RETRY_RETX_INTERVAL(2000);
+static const time::milliseconds AUTO_RETRY_RETX_INTERVAL = util::AUTO_RETRY_ADAPTIVE;
 
 } // namespace nfs_trace
 } // namespace ndn
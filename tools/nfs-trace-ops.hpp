@@ -0,0 +1,736 @@
+#ifndef NDNCXXEXT_TOOLS_NFS_TRACE_OPS_HPP
+#define NDNCXXEXT_TOOLS_NFS_TRACE_OPS_HPP
+
+#include "common.hpp"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+#include <boost/lexical_cast.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace ndn {
+namespace nfs_trace {
+
+enum NfsProc {
+  NFS_NONE,
+  NFS_GETATTR,
+  NFS_LOOKUP,
+  NFS_ACCESS,
+  NFS_READLINK,
+  NFS_READ,
+  NFS_WRITE,
+  NFS_READDIRP,
+  NFS_SETATTR,
+  NFS_CREATE,
+  NFS_MKDIR,
+  NFS_SYMLINK,
+  NFS_REMOVE,
+  NFS_RMDIR,
+  NFS_RENAME,
+  NFS_PROC_MAX
+};
+
+static std::vector<std::string> NfsProcStrings = {
+  "none",
+  "getattr",
+  "lookup",
+  "access",
+  "readlink",
+  "read",
+  "write",
+  "readdirp",
+  "setattr",
+  "create",
+  "mkdir",
+  "symlink",
+  "remove",
+  "rmdir",
+  "rename"
+};
+
+inline NfsProc
+parseNfsProc(const std::string& s)
+{
+  auto it = std::find(NfsProcStrings.begin(), NfsProcStrings.end(), s);
+  if (it != NfsProcStrings.end()) {
+    return static_cast<NfsProc>(it - NfsProcStrings.begin());
+  }
+  return NFS_NONE;
+}
+
+/** \brief perfect hash of NfsProc names
+ *
+ *  The hash is collision-free over NfsProcStrings; other strings must be compared after lookup.
+ */
+inline size_t
+hashNfsProc(const char* s, size_t len)
+{
+  return (static_cast<uint8_t>(s[0]) + 3 * static_cast<uint8_t>(s[2]) +
+          3 * static_cast<uint8_t>(s[len - 1]) + len) % 32;
+}
+
+/** \brief looks up NfsProc by name with a perfect hash
+ *  \return NfsProc, or NFS_NONE if not found
+ */
+inline NfsProc
+parseNfsProc(const char* s, size_t len)
+{
+  static const std::vector<NfsProc> table = [] {
+    std::vector<NfsProc> table(32, NFS_NONE);
+    for (int proc = NFS_NONE + 1; proc < NFS_PROC_MAX; ++proc) {
+      const std::string& name = NfsProcStrings[proc];
+      size_t h = hashNfsProc(name.data(), name.size());
+      BOOST_ASSERT(table[h] == NFS_NONE);
+      table[h] = static_cast<NfsProc>(proc);
+    }
+    return table;
+  }();
+
+  if (len < 3) {
+    return NFS_NONE;
+  }
+  NfsProc proc = table[hashNfsProc(s, len)];
+  const std::string& name = NfsProcStrings[proc];
+  if (name.size() != len || std::memcmp(name.data(), s, len) != 0) {
+    return NFS_NONE;
+  }
+  return proc;
+}
+
+typedef uint64_t NfsTimestamp; // microseconds from epoch
+
+inline NfsTimestamp
+parseNfsTimestamp(const std::string& s)
+{
+  double d = boost::lexical_cast<double>(s);
+  return static_cast<NfsTimestamp>(d * 1000000);
+}
+
+/** \brief parses decimal digits in [begin,end)
+ *  \return whether the input is a non-empty sequence of digits
+ */
+inline bool
+parseDecimal(const char* begin, const char* end, uint64_t& n)
+{
+  if (begin == end) {
+    return false;
+  }
+  n = 0;
+  for (const char* p = begin; p != end; ++p) {
+    if (*p < '0' || *p > '9') {
+      return false;
+    }
+    n = n * 10 + (*p - '0');
+  }
+  return true;
+}
+
+/** \brief parses seconds with optional decimal fraction in [begin,end) as fixed-point
+ *
+ *  Digits beyond microseconds are truncated.
+ *  \return whether the input is well-formed
+ */
+inline bool
+parseNfsTimestamp(const char* begin, const char* end, NfsTimestamp& ts)
+{
+  const char* dot = static_cast<const char*>(std::memchr(begin, '.', end - begin));
+  uint64_t seconds = 0;
+  if (!parseDecimal(begin, dot == nullptr ? end : dot, seconds)) {
+    return false;
+  }
+  ts = seconds * 1000000;
+  if (dot == nullptr) {
+    return true;
+  }
+
+  uint64_t scale = 100000;
+  for (const char* p = dot + 1; p != end; ++p) {
+    if (*p < '0' || *p > '9') {
+      return false;
+    }
+    ts += (*p - '0') * scale;
+    scale /= 10;
+  }
+  return true;
+}
+
+/** \brief stable hash of a path, used as client key when trace has no client-id column
+ *
+ *  This is 32-bit FNV-1a, so that .ops and .opsbin give same keys on every platform.
+ */
+inline uint32_t
+hashNfsPath(const char* s, size_t len)
+{
+  uint32_t h = 2166136261;
+  for (size_t i = 0; i < len; ++i) {
+    h = (h ^ static_cast<uint8_t>(s[i])) * 16777619;
+  }
+  return h;
+}
+
+struct NfsOp
+{
+  NfsTimestamp timestamp;
+  NfsProc proc;
+  std::string path;
+  uint64_t version;
+  uint64_t segStart;
+  uint64_t nSegments;
+  uint32_t clientKey; ///< client-id column, or hashNfsPath if absent
+  bool hasClientId; ///< whether clientKey comes from client-id column
+};
+
+inline std::ostream&
+operator<<(std::ostream& os, const NfsOp& op)
+{
+  os << op.timestamp << ','
+     << NfsProcStrings[op.proc] << ','
+     << op.path << ','
+     << op.version << ','
+     << op.segStart << ','
+     << op.nSegments;
+  return os;
+}
+
+/** \brief an operation whose path refers to memory owned by a trace reader
+ */
+struct NfsOpRef
+{
+  NfsTimestamp timestamp;
+  NfsProc proc;
+  const char* path;
+  size_t pathLength;
+  uint64_t version;
+  uint64_t segStart;
+  uint64_t nSegments;
+  uint32_t clientKey;
+  bool hasClientId;
+
+  NfsOp
+  toNfsOp() const
+  {
+    return {timestamp, proc, std::string(path, pathLength), version, segStart, nSegments,
+            clientKey, hasClientId};
+  }
+};
+
+/** \brief reads operations from a trace
+ */
+class OpsReader : noncopyable
+{
+public:
+  virtual
+  ~OpsReader()
+  {
+  }
+
+  /** \return next accepted operation, or an operation with NFS_NONE at end of trace
+   */
+  virtual NfsOp
+  read() = 0;
+
+public:
+  /** \brief filters operations by timestamp
+   */
+  std::function<bool(const NfsTimestamp&)> acceptTimestamp;
+
+protected:
+  OpsReader()
+    : acceptTimestamp(bind([] { return true; }))
+  {
+  }
+};
+
+/** \brief parses .ops trace file from a stream
+ *
+ *  A line has six fields: timestamp,proc,path,version,segStart,nSegments;
+ *  an optional seventh field is a numeric client-id.
+ */
+class OpsParser : public OpsReader
+{
+public:
+  explicit
+  OpsParser(std::istream& is)
+    : m_is(is)
+  {
+  }
+
+  virtual NfsOp
+  read() NDNCXXEXT_DECL_OVERRIDE;
+
+private:
+  std::istream& m_is;
+};
+
+inline NfsOp
+OpsParser::read()
+{
+  while (true) {
+    NfsOp op = {NfsTimestamp(), NFS_NONE, "", 0, 0, 0, 0, false};
+    if (m_is.eof()) {
+      return op;
+    }
+
+    static std::string line;
+    std::getline(m_is, line);
+
+    size_t pos1 = line.find(','),
+           pos2 = line.find(',', pos1 + 1),
+           pos3 = line.find(',', pos2 + 1),
+           pos4 = line.find(',', pos3 + 1),
+           pos5 = line.find(',', pos4 + 1),
+           pos6 = line.find(',', pos5 + 1);
+    if (pos1 == std::string::npos ||
+        pos2 == std::string::npos ||
+        pos3 == std::string::npos ||
+        pos4 == std::string::npos ||
+        pos5 == std::string::npos) {
+      continue; // bad input line
+    }
+
+    op.timestamp = parseNfsTimestamp(line.substr(0, pos1));
+    if (!acceptTimestamp(op.timestamp)) {
+      continue;
+    }
+
+    op.proc = parseNfsProc(line.substr(pos1 + 1, pos2 - pos1 - 1));
+    if (op.proc == NFS_NONE) {
+      continue; // bad input line
+    }
+
+    op.path = line.substr(pos2 + 1, pos3 - pos2 - 1);
+
+    if (op.proc == NFS_READ || op.proc == NFS_WRITE || op.proc == NFS_READDIRP) {
+      op.version = parseNfsTimestamp(line.substr(pos3 + 1, pos4 - pos3 - 1));
+      op.segStart = boost::lexical_cast<uint64_t>(line.substr(pos4 + 1, pos5 - pos4 - 1));
+      op.nSegments = boost::lexical_cast<uint64_t>(line.substr(pos5 + 1, pos6 - pos5 - 1));
+    }
+
+    if (pos6 == std::string::npos) {
+      op.clientKey = hashNfsPath(op.path.data(), op.path.size());
+      op.hasClientId = false;
+    }
+    else {
+      uint64_t clientId = 0;
+      if (!parseDecimal(line.data() + pos6 + 1, line.data() + line.size(), clientId)) {
+        continue; // bad input line
+      }
+      op.clientKey = static_cast<uint32_t>(clientId);
+      op.hasClientId = true;
+    }
+
+    if (op.version == 0) {
+      // TODO reprocess the trace for accurate ctime or mtime
+      op.version = op.timestamp;
+    }
+
+    return op;
+  }
+  BOOST_ASSERT(false);
+  return {NfsTimestamp(), NFS_NONE, "", 0, 0, 0, 0};
+}
+
+/** \brief parses .ops trace file mapped into memory
+ *
+ *  Lines are tokenized in place; fields are parsed without copying or allocation.
+ *  Only the path of a returned NfsOp is copied out of the mapping.
+ *  Accepted input and acceptTimestamp semantics are same as OpsParser.
+ */
+class MappedOpsParser : public OpsReader
+{
+public:
+  /** \throw std::ios_base::failure file cannot be mapped
+   */
+  explicit
+  MappedOpsParser(const std::string& filename)
+    : m_file(filename)
+    , m_pos(m_file.data())
+    , m_end(m_file.data() + m_file.size())
+  {
+  }
+
+  /** \brief parses next accepted line into \p rec
+   *  \return false at end of file
+   */
+  bool
+  readRecord(NfsOpRef& rec);
+
+  virtual NfsOp
+  read() NDNCXXEXT_DECL_OVERRIDE
+  {
+    NfsOpRef rec;
+    if (!this->readRecord(rec)) {
+      return {NfsTimestamp(), NFS_NONE, "", 0, 0, 0, 0};
+    }
+    return rec.toNfsOp();
+  }
+
+private:
+  /** \brief parses a line in [begin,end) without newline
+   *  \return whether the line is well-formed and accepted
+   */
+  bool
+  parseLine(const char* begin, const char* end, NfsOpRef& rec);
+
+private:
+  boost::iostreams::mapped_file_source m_file;
+  const char* m_pos;
+  const char* m_end;
+};
+
+inline bool
+MappedOpsParser::readRecord(NfsOpRef& rec)
+{
+  while (m_pos < m_end) {
+    const char* begin = m_pos;
+    const char* eol = static_cast<const char*>(std::memchr(begin, '\n', m_end - begin));
+    const char* end = eol == nullptr ? m_end : eol;
+    m_pos = eol == nullptr ? m_end : eol + 1;
+
+    if (this->parseLine(begin, end, rec)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool
+MappedOpsParser::parseLine(const char* begin, const char* end, NfsOpRef& rec)
+{
+  const char* fields[8] = {begin};
+  int nCommas = 0;
+  for (const char* p = begin; p != end && nCommas < 6; ++p) {
+    if (*p == ',') {
+      fields[++nCommas] = p + 1;
+    }
+  }
+  if (nCommas < 5) {
+    return false; // bad input line
+  }
+  fields[nCommas + 1] = end + 1;
+  // field i is [fields[i], fields[i+1]-1); field 6 is optional client-id
+
+  if (!parseNfsTimestamp(fields[0], fields[1] - 1, rec.timestamp)) {
+    return false; // bad input line
+  }
+  if (!acceptTimestamp(rec.timestamp)) {
+    return false;
+  }
+
+  rec.proc = parseNfsProc(fields[1], fields[2] - 1 - fields[1]);
+  if (rec.proc == NFS_NONE) {
+    return false; // bad input line
+  }
+
+  rec.path = fields[2];
+  rec.pathLength = fields[3] - 1 - fields[2];
+
+  rec.version = rec.segStart = rec.nSegments = 0;
+  if (rec.proc == NFS_READ || rec.proc == NFS_WRITE || rec.proc == NFS_READDIRP) {
+    if (!parseNfsTimestamp(fields[3], fields[4] - 1, rec.version) ||
+        !parseDecimal(fields[4], fields[5] - 1, rec.segStart) ||
+        !parseDecimal(fields[5], fields[6] - 1, rec.nSegments)) {
+      return false; // bad input line
+    }
+  }
+
+  if (rec.version == 0) {
+    // TODO reprocess the trace for accurate ctime or mtime
+    rec.version = rec.timestamp;
+  }
+
+  if (nCommas < 6) {
+    rec.clientKey = hashNfsPath(rec.path, rec.pathLength);
+    rec.hasClientId = false;
+  }
+  else {
+    uint64_t clientId = 0;
+    if (!parseDecimal(fields[6], fields[7] - 1, clientId)) {
+      return false; // bad input line
+    }
+    rec.clientKey = static_cast<uint32_t>(clientId);
+    rec.hasClientId = true;
+  }
+  return true;
+}
+
+/** \brief .opsbin trace file layout
+ *
+ *  An .opsbin file contains a header, an array of fixed-size records, and a path table.
+ *  A record refers to its path by index into the path table. Its timestamp is encoded as
+ *  the difference from the previous record; a reset record (proc=NFS_NONE) carries an absolute
+ *  timestamp in version field, and precedes any record whose difference does not fit.
+ *  The path table is an array of nPaths+1 offsets into the string area that follows it;
+ *  path i is [offsets[i], offsets[i+1]).
+ *
+ *  The file is written in host byte order.
+ */
+struct OpsBinFormat
+{
+  struct Header
+  {
+    char magic[8];
+    uint64_t nRecords;
+    uint64_t nPaths;
+    uint64_t pathTableOffset; ///< from start of file
+  };
+
+  struct Record
+  {
+    int32_t timestampDelta; ///< microseconds since previous record
+    uint32_t pathIndex;
+    uint64_t version; ///< absolute timestamp in a reset record
+    uint32_t segStart;
+    uint32_t nSegments;
+    uint8_t proc; ///< NfsProc, or NFS_NONE in a reset record
+    uint8_t hasClientId; ///< whether clientKey is client-id rather than path hash
+    uint8_t reserved[2];
+    uint32_t clientKey;
+  };
+};
+
+static const char OpsBinMagic[8] = {'N', 'F', 'S', 'O', 'P', 'S', 'B', '1'};
+
+/** \brief writes .opsbin trace file
+ */
+class OpsBinWriter : noncopyable
+{
+public:
+  explicit
+  OpsBinWriter(const std::string& filename);
+
+  /** \brief appends an operation
+   *  \return false if segStart or nSegments does not fit in the record
+   */
+  bool
+  append(const NfsOpRef& op);
+
+  /** \brief writes the path table, and completes the header
+   *  \return whether the file is written successfully
+   */
+  bool
+  close();
+
+  uint64_t
+  getNRecords() const
+  {
+    return m_header.nRecords;
+  }
+
+  size_t
+  getNPaths() const
+  {
+    return m_offsets.size() - 1;
+  }
+
+private:
+  void
+  writeRecord(const OpsBinFormat::Record& rec);
+
+private:
+  std::ofstream m_file;
+  OpsBinFormat::Header m_header;
+  NfsTimestamp m_lastTimestamp;
+  std::unordered_map<std::string, uint32_t> m_pathIndex;
+  std::vector<uint64_t> m_offsets;
+  std::string m_strings;
+  std::string m_pathBuffer;
+};
+
+inline
+OpsBinWriter::OpsBinWriter(const std::string& filename)
+  : m_file(filename, std::ios::binary | std::ios::trunc)
+  , m_header()
+  , m_lastTimestamp(0)
+  , m_offsets(1, 0)
+{
+  std::copy(OpsBinMagic, OpsBinMagic + sizeof(OpsBinMagic), m_header.magic);
+  // header is rewritten in close()
+  m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+}
+
+inline bool
+OpsBinWriter::append(const NfsOpRef& op)
+{
+  if (op.segStart > std::numeric_limits<uint32_t>::max() ||
+      op.nSegments > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  int64_t delta = static_cast<int64_t>(op.timestamp - m_lastTimestamp);
+  if (m_header.nRecords == 0 ||
+      delta < std::numeric_limits<int32_t>::min() ||
+      delta > std::numeric_limits<int32_t>::max()) {
+    OpsBinFormat::Record reset = {};
+    reset.proc = NFS_NONE;
+    reset.version = op.timestamp;
+    this->writeRecord(reset);
+    delta = 0;
+  }
+  m_lastTimestamp = op.timestamp;
+
+  m_pathBuffer.assign(op.path, op.pathLength);
+  auto inserted = m_pathIndex.insert({m_pathBuffer, static_cast<uint32_t>(m_pathIndex.size())});
+  if (inserted.second) {
+    m_strings.append(op.path, op.pathLength);
+    m_offsets.push_back(m_strings.size());
+  }
+
+  OpsBinFormat::Record rec = {};
+  rec.timestampDelta = static_cast<int32_t>(delta);
+  rec.pathIndex = inserted.first->second;
+  rec.version = op.version;
+  rec.segStart = static_cast<uint32_t>(op.segStart);
+  rec.nSegments = static_cast<uint32_t>(op.nSegments);
+  rec.proc = static_cast<uint8_t>(op.proc);
+  rec.clientKey = op.clientKey;
+  rec.hasClientId = op.hasClientId;
+  this->writeRecord(rec);
+  return true;
+}
+
+inline void
+OpsBinWriter::writeRecord(const OpsBinFormat::Record& rec)
+{
+  m_file.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+  ++m_header.nRecords;
+}
+
+inline bool
+OpsBinWriter::close()
+{
+  m_header.nPaths = m_offsets.size() - 1;
+  m_header.pathTableOffset = sizeof(m_header) + m_header.nRecords * sizeof(OpsBinFormat::Record);
+  m_file.write(reinterpret_cast<const char*>(m_offsets.data()),
+               m_offsets.size() * sizeof(m_offsets[0]));
+  m_file.write(m_strings.data(), m_strings.size());
+
+  m_file.seekp(0);
+  m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+  m_file.close();
+  return !m_file.fail();
+}
+
+/** \brief reads .opsbin trace file mapped into memory
+ *
+ *  Records and paths are used in place; readRecord() does not copy or allocate.
+ */
+class OpsBinReader : public OpsReader
+{
+public:
+  /** \throw std::ios_base::failure file cannot be mapped
+   */
+  explicit
+  OpsBinReader(const std::string& filename);
+
+  /** \return whether the file has a valid header and path table;
+   *          an invalid file is read as an empty trace
+   */
+  bool
+  isValid() const
+  {
+    return m_pos != nullptr;
+  }
+
+  /** \brief reads next accepted operation into \p rec
+   *  \return false at end of file
+   */
+  bool
+  readRecord(NfsOpRef& rec);
+
+  virtual NfsOp
+  read() NDNCXXEXT_DECL_OVERRIDE
+  {
+    NfsOpRef rec;
+    if (!this->readRecord(rec)) {
+      return {NfsTimestamp(), NFS_NONE, "", 0, 0, 0, 0};
+    }
+    return rec.toNfsOp();
+  }
+
+private:
+  boost::iostreams::mapped_file_source m_file;
+  const OpsBinFormat::Record* m_pos;
+  const OpsBinFormat::Record* m_end;
+  uint64_t m_nPaths;
+  const uint64_t* m_offsets;
+  const char* m_strings;
+  NfsTimestamp m_lastTimestamp;
+};
+
+inline
+OpsBinReader::OpsBinReader(const std::string& filename)
+  : m_file(filename)
+  , m_pos(nullptr)
+  , m_end(nullptr)
+  , m_nPaths(0)
+  , m_offsets(nullptr)
+  , m_strings(nullptr)
+  , m_lastTimestamp(0)
+{
+  typedef OpsBinFormat::Header Header;
+  typedef OpsBinFormat::Record Record;
+
+  const char* data = m_file.data();
+  uint64_t size = m_file.size();
+  if (size < sizeof(Header)) {
+    return;
+  }
+  const Header* header = reinterpret_cast<const Header*>(data);
+  if (!std::equal(header->magic, header->magic + sizeof(header->magic), OpsBinMagic) ||
+      header->nRecords > (size - sizeof(Header)) / sizeof(Record) ||
+      header->pathTableOffset != sizeof(Header) + header->nRecords * sizeof(Record) ||
+      header->nPaths >= (size - header->pathTableOffset) / sizeof(uint64_t)) {
+    return;
+  }
+
+  const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data + header->pathTableOffset);
+  const char* strings = reinterpret_cast<const char*>(offsets + header->nPaths + 1);
+  if (offsets[header->nPaths] > static_cast<uint64_t>(data + size - strings)) {
+    return;
+  }
+
+  m_pos = reinterpret_cast<const Record*>(data + sizeof(Header));
+  m_end = m_pos + header->nRecords;
+  m_nPaths = header->nPaths;
+  m_offsets = offsets;
+  m_strings = strings;
+}
+
+inline bool
+OpsBinReader::readRecord(NfsOpRef& rec)
+{
+  for (; m_pos != m_end; ++m_pos) {
+    if (m_pos->proc == NFS_NONE) {
+      m_lastTimestamp = m_pos->version;
+      continue;
+    }
+    m_lastTimestamp += m_pos->timestampDelta;
+
+    if (m_pos->pathIndex >= m_nPaths || m_pos->proc >= NFS_PROC_MAX ||
+        m_offsets[m_pos->pathIndex] > m_offsets[m_pos->pathIndex + 1] ||
+        m_offsets[m_pos->pathIndex + 1] > m_offsets[m_nPaths] ||
+        !acceptTimestamp(m_lastTimestamp)) {
+      continue;
+    }
+
+    rec.timestamp = m_lastTimestamp;
+    rec.proc = static_cast<NfsProc>(m_pos->proc);
+    rec.path = m_strings + m_offsets[m_pos->pathIndex];
+    rec.pathLength = m_offsets[m_pos->pathIndex + 1] - m_offsets[m_pos->pathIndex];
+    rec.version = m_pos->version;
+    rec.segStart = m_pos->segStart;
+    rec.nSegments = m_pos->nSegments;
+    rec.clientKey = m_pos->clientKey;
+    rec.hasClientId = m_pos->hasClientId != 0;
+    ++m_pos;
+    return true;
+  }
+  return false;
+}
+
+} // namespace nfs_trace
+} // namespace ndn
+
+#endif // NDNCXXEXT_TOOLS_NFS_TRACE_OPS_HPP
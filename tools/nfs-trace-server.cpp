@@ -1,9 +1,11 @@
 #include "standalone-client-face.hpp"
 #include "nfs-trace-common.hpp"
 #include <fstream>
+#include <unordered_map>
 #include <unordered_set>
 #include "util/request-segments.hpp"
 #include "util/face-trace-writer.hpp"
+#include "util/logger.hpp"
 
 namespace ndn {
 namespace nfs_trace {
@@ -14,10 +16,12 @@ using ndn::util::AutoRetryLimited;
 class Server : noncopyable
 {
 public:
-  /** \param prefix Name prefix to register with forwarder
+  /** \param prefix Name prefix to listen on
    *  \param prefixes Name prefix to serve
+   *  \param wantRegister whether to register \p prefix with forwarder
    */
-  Server(ClientFace& face, const Name& prefix, const std::vector<Name>& prefixes);
+  Server(ClientFace& face, const Name& prefix, const std::vector<Name>& prefixes,
+         bool wantRegister = true);
 
 private:
   bool
@@ -35,6 +39,11 @@ private:
   answerSimple(const Interest& interest, const std::vector<name::Component>& appendToName,
                size_t payloadSize);
 
+  /** \return Data template with \p payloadSize octets of payload
+   */
+  const DataTemplate&
+  getTemplate(size_t payloadSize);
+
   /** \brief fetches from client after a WRITE request
    */
   void
@@ -46,16 +55,18 @@ private:
   //const std::vector<Name> m_prefixes;
   const std::unordered_set<Name> m_prefixes;
   uint8_t m_payloadBuffer[ndn::MAX_NDN_PACKET_SIZE];
+  std::unordered_map<size_t, DataTemplate> m_templates; ///< payloadSize => template
 };
 
-Server::Server(ClientFace& face, const Name& prefix, const std::vector<Name>& prefixes)
+Server::Server(ClientFace& face, const Name& prefix, const std::vector<Name>& prefixes,
+               bool wantRegister)
   : m_face(face)
   , m_prefix(prefix)
   //, m_prefixes(prefixes)
   , m_prefixes(prefixes.begin(), prefixes.end())
 {
   std::fill_n(m_payloadBuffer, sizeof(m_payloadBuffer), 0xBB);
-  m_face.listen(m_prefix, bind(&Server::processInterest, this, _2));
+  m_face.listen(m_prefix, bind(&Server::processInterest, this, _2), wantRegister);
 }
 
 bool
@@ -132,9 +143,20 @@ Server::answerSimple(const Interest& interest, const std::vector<name::Component
   for (const name::Component& comp : appendToName) {
     dataName.append(comp);
   }
-  Data data(dataName);
-  data.setContent(m_payloadBuffer, std::min(payloadSize, sizeof(m_payloadBuffer)));
-  m_face.reply(interest, data);
+  m_face.reply(interest, this->getTemplate(payloadSize), dataName);
+}
+
+const DataTemplate&
+Server::getTemplate(size_t payloadSize)
+{
+  payloadSize = std::min(payloadSize, sizeof(m_payloadBuffer));
+  auto it = m_templates.find(payloadSize);
+  if (it == m_templates.end()) {
+    Data prototype;
+    prototype.setContent(m_payloadBuffer, payloadSize);
+    it = m_templates.emplace(payloadSize, DataTemplate(prototype)).first;
+  }
+  return it->second;
 }
 
 void
@@ -185,9 +207,24 @@ server_main(int argc, char* argv[])
   boost::asio::io_service io;
   StandaloneClientFace face(io);
   face.shouldNackUnmatchedInterest = true;
-  util::FaceTraceWriter::connect(face);
-
-  Server server(face, "ndn:/NFS", prefixes);
+  auto traceWriter = enableFaceTrace(face);
+
+  // register each served path, so that forwarder can route precisely
+  bool shouldRegisterPaths = getenv("NFS_REGISTER_PATHS") != nullptr;
+  Server server(face, "ndn:/NFS", prefixes, !shouldRegisterPaths);
+  if (shouldRegisterPaths) {
+    PrefixRegistrar& registrar = face.getPrefixRegistrar();
+    registrar.registerPrefixes(prefixes,
+      [&registrar] (const std::vector<PrefixRegistrar::Result>&) {
+        const PrefixRegistrar::Counters& cnt = registrar.getCounters();
+        LOG("RibRegister done prefixes=" << cnt.nRequested << " commands=" << cnt.nCommands
+            << " covered=" << cnt.nCovered << " succeeded=" << cnt.nSucceeded
+            << " failed=" << cnt.nFailed
+            << " max-latency=" << time::duration_cast<time::milliseconds>(cnt.maxLatency)
+            << " avg-latency=" << time::duration_cast<time::milliseconds>(
+                                    cnt.totalLatency / std::max<uint64_t>(cnt.nCommands, 1)));
+      });
+  }
   io.run();
 
   return 0;
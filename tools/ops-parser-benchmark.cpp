@@ -0,0 +1,98 @@
+/**
+ *  ops-parser-benchmark compares .ops trace parsers of nfs-trace-client.
+ *
+ *  It parses the whole trace file with each parser, and reports lines per second.
+ *  OpsParser reads the file as a stream. MappedOpsParser maps the file into memory;
+ *  it is measured both with read(), which copies the path into NfsOp,
+ *  and with readRecord(), which does not copy.
+ *  If an .opsbin file converted from the same trace is given, OpsBinReader is measured too.
+ */
+
+#include "nfs-trace-ops.hpp"
+#include <fstream>
+#include <algorithm>
+
+namespace ndn {
+namespace ops_parser_benchmark {
+
+using namespace ndn::nfs_trace;
+
+static void
+report(const std::string& title, size_t nLines, size_t nOps,
+       const time::steady_clock::Duration& duration)
+{
+  double seconds = time::duration_cast<time::microseconds>(duration).count() / 1000000.0;
+  std::cout << title
+            << " ops=" << nOps
+            << " time=" << time::duration_cast<time::milliseconds>(duration).count() << "ms"
+            << " lines/s=" << static_cast<uint64_t>(nLines / seconds) << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 2 && argc != 3) {
+    std::cerr << "USAGE: ./ops-parser-benchmark trace.ops [trace.opsbin]" << std::endl;
+    return 1;
+  }
+
+  size_t nLines = 0;
+  {
+    boost::iostreams::mapped_file_source file(argv[1]);
+    nLines = std::count(file.data(), file.data() + file.size(), '\n');
+  }
+
+  {
+    std::ifstream is(argv[1]);
+    OpsParser parser(is);
+    size_t nOps = 0;
+    time::steady_clock::TimePoint t0 = time::steady_clock::now();
+    while (parser.read().proc != NFS_NONE) {
+      ++nOps;
+    }
+    report("OpsParser", nLines, nOps, time::steady_clock::now() - t0);
+  }
+
+  {
+    MappedOpsParser parser(argv[1]);
+    size_t nOps = 0;
+    time::steady_clock::TimePoint t0 = time::steady_clock::now();
+    while (parser.read().proc != NFS_NONE) {
+      ++nOps;
+    }
+    report("MappedOpsParser::read", nLines, nOps, time::steady_clock::now() - t0);
+  }
+
+  {
+    MappedOpsParser parser(argv[1]);
+    NfsOpRef rec;
+    size_t nOps = 0;
+    time::steady_clock::TimePoint t0 = time::steady_clock::now();
+    while (parser.readRecord(rec)) {
+      ++nOps;
+    }
+    report("MappedOpsParser::readRecord", nLines, nOps, time::steady_clock::now() - t0);
+  }
+
+  if (argc > 2) {
+    OpsBinReader reader(argv[2]);
+    NfsOpRef rec;
+    size_t nOps = 0;
+    time::steady_clock::TimePoint t0 = time::steady_clock::now();
+    while (reader.readRecord(rec)) {
+      ++nOps;
+    }
+    report("OpsBinReader::readRecord", nLines, nOps, time::steady_clock::now() - t0);
+  }
+
+  return 0;
+}
+
+} // namespace ops_parser_benchmark
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::ops_parser_benchmark::main(argc, argv);
+}
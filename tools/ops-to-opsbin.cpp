@@ -0,0 +1,54 @@
+/**
+ *  ops-to-opsbin converts .ops trace file to .opsbin format.
+ *
+ *  .opsbin is read by nfs-trace-client without parsing text; see OpsBinFormat.
+ *  Lines that cannot be parsed are skipped, same as nfs-trace-client reading .ops.
+ */
+
+#include "nfs-trace-ops.hpp"
+
+namespace ndn {
+namespace ops_to_opsbin {
+
+using namespace ndn::nfs_trace;
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 3) {
+    std::cerr << "USAGE: ./ops-to-opsbin input.ops output.opsbin" << std::endl;
+    return 1;
+  }
+
+  MappedOpsParser parser(argv[1]);
+  OpsBinWriter writer(argv[2]);
+
+  NfsOpRef op;
+  uint64_t nOps = 0, nSkipped = 0;
+  while (parser.readRecord(op)) {
+    ++nOps;
+    if (!writer.append(op)) {
+      ++nSkipped;
+    }
+  }
+
+  if (!writer.close()) {
+    std::cerr << "cannot write " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cout << "ops=" << nOps
+            << " skipped=" << nSkipped
+            << " records=" << writer.getNRecords()
+            << " paths=" << writer.getNPaths() << std::endl;
+  return 0;
+}
+
+} // namespace ops_to_opsbin
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::ops_to_opsbin::main(argc, argv);
+}
@@ -0,0 +1,85 @@
+/**
+ *  scheduler-benchmark compares SchedulerBase implementations.
+ *
+ *  It schedules nTimers concurrent events with delays between 100ms and 1000ms,
+ *  cancels most of them as if the Interests were satisfied, and runs until the rest fire.
+ *  The same workload is repeated nRounds times, so that steady state cost is visible.
+ */
+
+#include "util/scheduler.hpp"
+#include "util/timing-wheel-scheduler.hpp"
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+namespace ndn {
+namespace scheduler_benchmark {
+
+static void
+runBenchmark(const std::string& title, boost::asio::io_service& io,
+             util::SchedulerBase& scheduler, size_t nTimers, int nRounds)
+{
+  boost::random::mt19937 gen;
+  boost::random::uniform_int_distribution<int> delayDist(100, 1000);
+  std::vector<util::SchedulerEventId> ids(nTimers);
+
+  for (int round = 0; round < nRounds; ++round) {
+    size_t nFired = 0;
+    time::steady_clock::TimePoint t0 = time::steady_clock::now();
+    for (size_t i = 0; i < nTimers; ++i) {
+      ids[i] = scheduler.schedule(time::milliseconds(delayDist(gen)), [&nFired] { ++nFired; });
+    }
+    time::steady_clock::TimePoint t1 = time::steady_clock::now();
+    for (size_t i = 0; i < nTimers; ++i) {
+      if (i % 10 != 0) {
+        scheduler.cancel(ids[i]);
+      }
+      ids[i].reset();
+    }
+    time::steady_clock::TimePoint t2 = time::steady_clock::now();
+    io.run();
+    io.reset();
+    time::steady_clock::TimePoint t3 = time::steady_clock::now();
+
+    std::cout << title << " round=" << round
+              << " schedule=" << time::duration_cast<time::microseconds>(t1 - t0).count() << "us"
+              << " cancel=" << time::duration_cast<time::microseconds>(t2 - t1).count() << "us"
+              << " run=" << time::duration_cast<time::milliseconds>(t3 - t2).count() << "ms"
+              << " fired=" << nFired << std::endl;
+  }
+}
+
+int
+main(int argc, char* argv[])
+{
+  size_t nTimers = 100000;
+  int nRounds = 3;
+  if (argc > 1) {
+    nTimers = boost::lexical_cast<size_t>(argv[1]);
+  }
+  if (argc > 2) {
+    nRounds = boost::lexical_cast<int>(argv[2]);
+  }
+
+  {
+    boost::asio::io_service io;
+    util::SchedulerWrapper scheduler(io);
+    runBenchmark("SchedulerWrapper", io, scheduler, nTimers, nRounds);
+  }
+  {
+    boost::asio::io_service io;
+    util::TimingWheelScheduler scheduler(io);
+    runBenchmark("TimingWheelScheduler", io, scheduler, nTimers, nRounds);
+  }
+
+  return 0;
+}
+
+} // namespace scheduler_benchmark
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::scheduler_benchmark::main(argc, argv);
+}
@@ -0,0 +1,165 @@
+/**
+ *  sharded-producer-benchmark measures how ShardedClientFace producer throughput
+ *  scales with the number of consumers.
+ *
+ *  The producer has shardsPerCore shards per core sharing UDP port 6363. For each consumer
+ *  count N, consumers on ports 6364 to 6363+N send Interests to port 6363; the kernel spreads
+ *  them among unconnected shards by source port. Each consumer runs on its own thread,
+ *  and keeps a window of outstanding Interests. The producer answers every Interest
+ *  with a Data of payloadSize octets. Interests/s is reported for each N.
+ *
+ *  Consumers also take a core each, so the scaling is bounded by half of available cores
+ *  when N reaches hardware concurrency. Consumers are hashed onto shards, so two consumers
+ *  may share a shard.
+ *
+ *  Usage: sharded-producer-benchmark [seconds] [payloadSize] [maxConsumers] [shardsPerCore]
+ */
+
+#include "sharded-client-face.hpp"
+#include "transport/udp-transport.hpp"
+#include <boost/lexical_cast.hpp>
+#include <atomic>
+#include <thread>
+
+namespace ndn {
+namespace sharded_producer_benchmark {
+
+static const uint16_t PRODUCER_PORT = 6363;
+/** \brief remote endpoint of shard 0; nothing listens there
+ */
+static const char REMOTE[] = "udp4://127.0.0.1:6362";
+static const size_t WINDOW = 64;
+
+class Consumer : noncopyable
+{
+public:
+  explicit
+  Consumer(uint16_t localPort)
+    : m_face(m_io, unique_ptr<Transport>(new UdpTransport(
+               util::FaceUri("udp4://127.0.0.1:" + std::to_string(PRODUCER_PORT)), localPort)))
+    , m_nSent(0)
+    , m_nReceived(0)
+  {
+  }
+
+  void
+  start()
+  {
+    m_thread = std::thread([this] {
+      for (size_t i = 0; i < WINDOW; ++i) {
+        this->sendInterest();
+      }
+      m_io.run();
+    });
+  }
+
+  void
+  stop()
+  {
+    m_io.stop();
+    m_thread.join();
+  }
+
+  uint64_t
+  getNReceived() const
+  {
+    return m_nReceived;
+  }
+
+private:
+  void
+  sendInterest()
+  {
+    Interest interest(Name("/P").appendNumber(m_nSent++));
+    m_face.request(interest,
+                   bind([this] { ++m_nReceived; this->sendInterest(); }),
+                   bind([this] { this->sendInterest(); }),
+                   bind([this] { this->sendInterest(); }),
+                   time::milliseconds(500));
+  }
+
+private:
+  boost::asio::io_service m_io;
+  StandaloneClientFace m_face;
+  std::thread m_thread;
+  uint64_t m_nSent;
+  std::atomic<uint64_t> m_nReceived;
+};
+
+static double
+runBenchmark(size_t nConsumers, const time::seconds& duration, size_t payloadSize,
+             size_t shardsPerCore)
+{
+  ShardedClientFace producer(util::FaceUri(REMOTE), PRODUCER_PORT, shardsPerCore);
+
+  std::vector<uint8_t> payload(payloadSize);
+  producer.listen("/P", [&payload] (ClientFace& face, const Name&, const Interest& interest) {
+    Data data(interest.getName());
+    data.setContent(payload.data(), payload.size());
+    face.reply(interest, data);
+  }, false);
+  producer.start();
+
+  std::vector<unique_ptr<Consumer>> consumers;
+  for (size_t i = 0; i < nConsumers; ++i) {
+    consumers.emplace_back(new Consumer(PRODUCER_PORT + 1 + i));
+  }
+  for (unique_ptr<Consumer>& consumer : consumers) {
+    consumer->start();
+  }
+
+  std::this_thread::sleep_for(duration);
+
+  for (unique_ptr<Consumer>& consumer : consumers) {
+    consumer->stop();
+  }
+  producer.stop();
+
+  uint64_t nReceived = 0;
+  for (unique_ptr<Consumer>& consumer : consumers) {
+    nReceived += consumer->getNReceived();
+  }
+  return nReceived / static_cast<double>(duration.count());
+}
+
+int
+main(int argc, char* argv[])
+{
+  int seconds = 5;
+  size_t payloadSize = 100;
+  size_t maxConsumers = std::max(std::thread::hardware_concurrency(), 1U);
+  size_t shardsPerCore = 1;
+  if (argc > 1) {
+    seconds = boost::lexical_cast<int>(argv[1]);
+  }
+  if (argc > 2) {
+    payloadSize = boost::lexical_cast<size_t>(argv[2]);
+  }
+  if (argc > 3) {
+    maxConsumers = boost::lexical_cast<size_t>(argv[3]);
+  }
+  if (argc > 4) {
+    shardsPerCore = boost::lexical_cast<size_t>(argv[4]);
+  }
+
+  double baseRate = 0.0;
+  for (size_t nConsumers = 1; nConsumers <= maxConsumers; nConsumers *= 2) {
+    double rate = runBenchmark(nConsumers, time::seconds(seconds), payloadSize, shardsPerCore);
+    if (nConsumers == 1) {
+      baseRate = rate;
+    }
+    std::cout << "consumers=" << nConsumers
+              << " rate=" << static_cast<uint64_t>(rate) << "Interests/s"
+              << " speedup=" << rate / std::max(baseRate, 1.0) << std::endl;
+  }
+  return 0;
+}
+
+} // namespace sharded_producer_benchmark
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::sharded_producer_benchmark::main(argc, argv);
+}
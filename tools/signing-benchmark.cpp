@@ -0,0 +1,102 @@
+/**
+ *  signing-benchmark measures Data signing throughput of SigningPool.
+ *
+ *  nData Data packets of payloadSize octets are submitted in bursts, and the run ends
+ *  when all are signed. The same workload is run with each worker count.
+ *  Worker count 0 signs inline on the io thread.
+ *
+ *  Usage: signing-benchmark [identity|digest] [nData] [payloadSize] [nWorkers...]
+ *  Default identity is the KeyChain default identity.
+ */
+
+#include "signing-pool.hpp"
+#include <boost/lexical_cast.hpp>
+
+namespace ndn {
+namespace signing_benchmark {
+
+static const size_t BURST_SIZE = 64;
+
+static void
+runBenchmark(const Name& identity, size_t nWorkers, size_t nData, size_t payloadSize)
+{
+  boost::asio::io_service io;
+  // queue holds all Data, so that nothing is signed inline unless nWorkers is zero
+  SigningPool pool(io, nWorkers, identity, nData);
+
+  std::vector<uint8_t> payload(payloadSize);
+  size_t nSubmitted = 0;
+  size_t nSigned = 0;
+  auto onSigned = [&] (const Data&) {
+    if (++nSigned == nData) {
+      io.stop();
+    }
+  };
+  std::function<void()> submitBurst = [&] {
+    for (size_t i = 0; i < BURST_SIZE && nSubmitted < nData; ++i, ++nSubmitted) {
+      Data data(Name("/signing-benchmark").appendNumber(nSubmitted));
+      data.setContent(payload.data(), payload.size());
+      pool.submit(data, onSigned);
+    }
+    if (nSubmitted < nData) {
+      io.post(submitBurst);
+    }
+  };
+  io.post(submitBurst);
+
+  // keeps io running while workers sign
+  boost::asio::io_service::work work(io);
+  time::steady_clock::TimePoint t0 = time::steady_clock::now();
+  io.run();
+  time::steady_clock::TimePoint t1 = time::steady_clock::now();
+  double seconds = time::duration_cast<time::microseconds>(t1 - t0).count() / 1000000.0;
+
+  const SigningPool::Counters& cnt = pool.getCounters();
+  std::cout << "workers=" << nWorkers
+            << " signed=" << nSigned << "/" << nData
+            << " rate=" << static_cast<uint64_t>(nSigned / seconds) << "Data/s"
+            << " inline=" << cnt.nInlineSigned
+            << " failed=" << cnt.nFailed
+            << " maxQueueDepth=" << cnt.maxQueueDepth << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+  Name identity;
+  size_t nData = 10000;
+  size_t payloadSize = 1000;
+  std::vector<size_t> workerCounts;
+  if (argc > 1) {
+    identity = std::string(argv[1]) == "digest" ? SigningPool::DIGEST_SHA256 : Name(argv[1]);
+  }
+  if (argc > 2) {
+    nData = boost::lexical_cast<size_t>(argv[2]);
+  }
+  if (argc > 3) {
+    payloadSize = boost::lexical_cast<size_t>(argv[3]);
+  }
+  for (int i = 4; i < argc; ++i) {
+    workerCounts.push_back(boost::lexical_cast<size_t>(argv[i]));
+  }
+  if (workerCounts.empty()) {
+    workerCounts.push_back(0);
+    for (size_t n = 1; n <= std::max(std::thread::hardware_concurrency(), 1U); n *= 2) {
+      workerCounts.push_back(n);
+    }
+  }
+
+  for (size_t nWorkers : workerCounts) {
+    runBenchmark(identity, nWorkers, nData, payloadSize);
+  }
+  return 0;
+}
+
+} // namespace signing_benchmark
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::signing_benchmark::main(argc, argv);
+}
@@ -1,14 +1,31 @@
 /**
  *  throttled-producer is a producer that simulates server processing time.
- *  It has a RandomEarlyNack mechanism, which starts to NACK requests if queue is somewhat full.
+ *  It has an active queue management policy, which NACKs some requests to limit queueing:
+ *  RandomEarlyNack starts to NACK arriving requests if queue is somewhat full;
+ *  CodelNack NACKs queued requests if their sojourn time stays above a target.
  *
  *  The last Name component of each request Interest must be ASCII-number x,
  *  where (x >> 48) gives the processing duration of the request.
+ *
+ *  Data are signed with DigestSha256, or with SIGNING_IDENTITY environment variable if set.
+ *  SIGNING_WORKERS environment variable sets the number of signing threads (default 0: inline).
+ *
+ *  If NACK_RETRY_AFTER environment variable is set, NACKs are encoded as LpPacket,
+ *  with a retry-after hint of the processing time of queued requests divided by workers.
+ *
+ *  SERVICE_WORKERS environment variable sets the number of requests processed in parallel
+ *  (default 1). SERVICE_DISCIPLINE=sjf serves the request with shortest duration first,
+ *  instead of in arrival order. Percentiles of queue wait and service time are logged
+ *  every STATS_INTERVAL seconds (default 10).
  */
 
 #include "standalone-client-face.hpp"
+#include "signing-pool.hpp"
 #include "util/logger.hpp"
 #include <queue>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 #include <boost/lexical_cast.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
@@ -16,7 +33,41 @@
 namespace ndn {
 namespace throttled_producer {
 
-class RandomEarlyNack
+/** \brief active queue management policy, which decides which requests are NACKed
+ */
+class ActiveQueueManagement : noncopyable
+{
+public:
+  virtual
+  ~ActiveQueueManagement()
+  {
+  }
+
+  virtual const char*
+  getName() const = 0;
+
+  /** \return whether to accept an arriving request
+   *  \param queueLength number of requests waiting or being processed
+   */
+  virtual bool
+  shouldAccept(size_t queueLength)
+  {
+    return true;
+  }
+
+  /** \return whether to process a request taken from the queue, false to NACK it
+   *  \param sojourn time the request has waited in queue
+   */
+  virtual bool
+  shouldProcess(const time::nanoseconds& sojourn, const time::steady_clock::TimePoint& now)
+  {
+    return true;
+  }
+};
+
+/** \brief NACKs arriving requests if queue length exceeds a random threshold
+ */
+class RandomEarlyNack : public ActiveQueueManagement
 {
 public:
   RandomEarlyNack(size_t minThres, size_t maxThres)
@@ -24,8 +75,14 @@ public:
   {
   }
 
-  bool
-  shouldAccept(size_t queueLength)
+  virtual const char*
+  getName() const NDNCXXEXT_DECL_OVERRIDE
+  {
+    return "red";
+  }
+
+  virtual bool
+  shouldAccept(size_t queueLength) NDNCXXEXT_DECL_OVERRIDE
   {
     return queueLength < m_dist(s_gen);
   }
@@ -36,35 +93,266 @@ private:
 };
 boost::random::mt19937 RandomEarlyNack::s_gen;
 
+/** \brief NACKs requests taken from the queue, based on their sojourn time, as in CoDel
+ *
+ *  When sojourn time has stayed above target for at least interval, the policy enters
+ *  NACKing state. It NACKs one request, and schedules the next NACK after interval/sqrt(count),
+ *  where count is the number of NACKs in this state, until sojourn time falls below target.
+ *  The algorithm follows RFC 8289, with request sojourn time in place of packet sojourn time.
+ */
+class CodelNack : public ActiveQueueManagement
+{
+public:
+  CodelNack(const time::nanoseconds& target, const time::nanoseconds& interval)
+    : m_target(target)
+    , m_interval(interval)
+    , m_firstAboveTime()
+    , m_isNacking(false)
+    , m_nextNackTime()
+    , m_count(0)
+    , m_lastCount(0)
+  {
+  }
+
+  virtual const char*
+  getName() const NDNCXXEXT_DECL_OVERRIDE
+  {
+    return "codel";
+  }
+
+  virtual bool
+  shouldProcess(const time::nanoseconds& sojourn,
+                const time::steady_clock::TimePoint& now) NDNCXXEXT_DECL_OVERRIDE
+  {
+    bool isAboveTarget = false;
+    if (sojourn < m_target) {
+      m_firstAboveTime = time::steady_clock::TimePoint();
+    }
+    else if (m_firstAboveTime == time::steady_clock::TimePoint()) {
+      m_firstAboveTime = now + m_interval;
+    }
+    else if (now >= m_firstAboveTime) {
+      isAboveTarget = true;
+    }
+
+    if (m_isNacking) {
+      if (!isAboveTarget) {
+        m_isNacking = false;
+        return true;
+      }
+      if (now >= m_nextNackTime) {
+        ++m_count;
+        m_nextNackTime = this->controlLaw(m_nextNackTime);
+        return false;
+      }
+      return true;
+    }
+
+    if (isAboveTarget) {
+      m_isNacking = true;
+      // resume near previous NACK rate if NACKing state was left recently
+      uint32_t delta = m_count - m_lastCount;
+      m_count = delta > 1 && now - m_nextNackTime < m_interval * 16 ? delta : 1;
+      m_lastCount = m_count;
+      m_nextNackTime = this->controlLaw(now);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  time::steady_clock::TimePoint
+  controlLaw(const time::steady_clock::TimePoint& t) const
+  {
+    return t + time::nanoseconds(static_cast<time::nanoseconds::rep>(
+                 m_interval.count() / std::sqrt(static_cast<double>(m_count))));
+  }
+
+private:
+  time::nanoseconds m_target;
+  time::nanoseconds m_interval;
+  time::steady_clock::TimePoint m_firstAboveTime; ///< zero if sojourn time is below target
+  bool m_isNacking;
+  time::steady_clock::TimePoint m_nextNackTime;
+  uint32_t m_count;
+  uint32_t m_lastCount;
+};
+
+/** \brief queue wait and service time of requests finished in a reporting period
+ */
+class ServiceStats
+{
+public:
+  ServiceStats()
+    : nRejected(0)
+  {
+  }
+
+  void
+  recordFinish(const time::nanoseconds& wait, const time::nanoseconds& service)
+  {
+    waits.push_back(wait);
+    services.push_back(service);
+  }
+
+  /** \brief writes a summary line, and starts a new period
+   */
+  void
+  report()
+  {
+    uint64_t nRequests = waits.size() + nRejected;
+    double nackRate = nRequests == 0 ? 0.0 : static_cast<double>(nRejected) / nRequests;
+    LOG("STATS finished=" << waits.size() << " rejected=" << nRejected <<
+        " nack-rate=" << nackRate <<
+        " wait=" << summarize(waits) << " service=" << summarize(services));
+    waits.clear();
+    services.clear();
+    nRejected = 0;
+  }
+
+  /** \return nearest-rank percentile \p p (between 0 and 1) of \p samples
+   *  \post \p samples is sorted
+   */
+  static time::nanoseconds
+  percentile(std::vector<time::nanoseconds>& samples, double p)
+  {
+    if (samples.empty()) {
+      return time::nanoseconds::zero();
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+    return samples[std::max(rank, static_cast<size_t>(1)) - 1];
+  }
+
+private:
+  /** \return p50/p90/p99/max in milliseconds
+   */
+  static std::string
+  summarize(std::vector<time::nanoseconds>& samples)
+  {
+    std::ostringstream os;
+    os << toMilliseconds(percentile(samples, 0.50)) << "/" <<
+          toMilliseconds(percentile(samples, 0.90)) << "/" <<
+          toMilliseconds(percentile(samples, 0.99)) << "/" <<
+          toMilliseconds(percentile(samples, 1.00));
+    return os.str();
+  }
+
+  static double
+  toMilliseconds(const time::nanoseconds& d)
+  {
+    return d.count() / 1000000.0;
+  }
+
+public:
+  uint64_t nRejected;
+  std::vector<time::nanoseconds> waits;
+  std::vector<time::nanoseconds> services;
+};
+
 class ThrottledProducer : noncopyable
 {
 public:
+  enum Discipline {
+    /** \brief requests are served in arrival order
+     */
+    DISCIPLINE_FIFO,
+    /** \brief request with shortest encoded duration is served first
+     */
+    DISCIPLINE_SJF
+  };
+
+  /** \param nWorkers number of requests processed in parallel, must be positive
+   */
   ThrottledProducer(ClientFace& face, Scheduler& scheduler,
-                    const Name& prefix, RandomEarlyNack& ren)
+                    const Name& prefix, ActiveQueueManagement& aqm,
+                    size_t nWorkers = 1, Discipline discipline = DISCIPLINE_FIFO)
     : m_face(face)
     , m_scheduler(scheduler)
-    , m_ren(ren)
+    , m_aqm(aqm)
+    , m_nWorkers(nWorkers)
+    , m_nBusyWorkers(0)
+    , m_queue(JobOrder{discipline})
+    , m_nextSeq(0)
+    , m_queuedDuration(time::milliseconds::zero())
   {
+    BOOST_ASSERT(nWorkers > 0);
     face.listen(prefix, bind(&ThrottledProducer::onInterest, this, std::placeholders::_2));
   }
 
+  ServiceStats&
+  getStats()
+  {
+    return m_stats;
+  }
+
+  /** \brief reports stats every \p interval
+   */
+  void
+  startReporting(const time::nanoseconds& interval)
+  {
+    m_scheduler.scheduleEvent(interval, [this, interval] {
+      m_stats.report();
+      this->startReporting(interval);
+    });
+  }
+
 private:
+  struct Job
+  {
+    Interest interest;
+    time::milliseconds duration;
+    uint64_t seq;
+    time::steady_clock::TimePoint arrival;
+    time::steady_clock::TimePoint start;
+  };
+
+  /** \brief orders Jobs in std::priority_queue, which serves the greatest first
+   */
+  struct JobOrder
+  {
+    Discipline discipline;
+
+    bool
+    operator()(const Job& a, const Job& b) const
+    {
+      if (discipline == DISCIPLINE_SJF && a.duration != b.duration) {
+        return a.duration > b.duration;
+      }
+      return a.seq > b.seq;
+    }
+  };
+
+  /** \return number of requests waiting or being processed
+   */
+  size_t
+  getLoad() const
+  {
+    return m_queue.size() + m_nBusyWorkers;
+  }
+
   void
   onInterest(const Interest& interest)
   {
-    if (!m_ren.shouldAccept(m_queue.size())) {
-      LOG("REJECT " << interest.getName() << " queue=" << m_queue.size());
-      Nack nack(Nack::BUSY, interest);
-      m_face.reply(interest, nack);
+    if (!m_aqm.shouldAccept(this->getLoad())) {
+      this->reject(interest);
       return;
     }
-    LOG("ACCEPT " << interest.getName() << " queue=" << m_queue.size());
 
-    bool isIdle = m_queue.empty();
-    m_queue.push(interest);
-    if (isIdle) {
-      this->startJob();
-    }
+    time::milliseconds duration = this->extractDuration(interest.getName());
+    m_queue.push(Job{interest, duration, ++m_nextSeq, time::steady_clock::now(),
+                     time::steady_clock::TimePoint()});
+    m_queuedDuration += duration;
+    this->startJobs();
+  }
+
+  void
+  reject(const Interest& interest)
+  {
+    ++m_stats.nRejected;
+    Nack nack(Nack::BUSY, interest);
+    nack.setRetryAfter(m_queuedDuration / static_cast<time::milliseconds::rep>(m_nWorkers));
+    m_face.reply(interest, nack);
   }
 
   time::milliseconds
@@ -75,66 +363,133 @@ private:
   }
 
   void
-  startJob()
+  startJobs()
   {
-    BOOST_ASSERT(!m_queue.empty());
-    const Name& name = m_queue.front().getName();
-    time::milliseconds duration = this->extractDuration(name);
-    LOG("START " << name << " duration=" << duration.count());
+    while (m_nBusyWorkers < m_nWorkers && !m_queue.empty()) {
+      Job job = m_queue.top();
+      m_queue.pop();
+      m_queuedDuration -= job.duration;
+
+      time::steady_clock::TimePoint now = time::steady_clock::now();
+      if (!m_aqm.shouldProcess(now - job.arrival, now)) {
+        this->reject(job.interest);
+        continue;
+      }
 
-    m_scheduler.scheduleEvent(duration, bind(&ThrottledProducer::onJobFinish, this));
+      ++m_nBusyWorkers;
+      job.start = now;
+      m_scheduler.scheduleEvent(job.duration, bind(&ThrottledProducer::onJobFinish, this, job));
+    }
   }
 
   void
-  onJobFinish()
+  onJobFinish(const Job& job)
   {
-    BOOST_ASSERT(!m_queue.empty());
-    LOG("FINISH " << m_queue.front().getName() << " queue=" << (m_queue.size() - 1));
+    --m_nBusyWorkers;
+    time::steady_clock::TimePoint now = time::steady_clock::now();
+    m_stats.recordFinish(job.start - job.arrival, now - job.start);
 
-    Data data(m_queue.front().getName());
-    m_keyChain.signWithSha256(data);
-    m_face.reply(m_queue.front(), data);
-    m_queue.pop();
+    // signed by face's signing pool
+    Data data(job.interest.getName());
+    m_face.reply(job.interest, data);
 
-    if (m_queue.empty()) {
-      LOG("IDLE");
-      return;
-    }
-    this->startJob();
+    this->startJobs();
   }
 
 private:
   ClientFace& m_face;
-  KeyChain m_keyChain;
   Scheduler& m_scheduler;
-  std::queue<Interest> m_queue;
-  RandomEarlyNack& m_ren;
+  ActiveQueueManagement& m_aqm;
+  size_t m_nWorkers;
+  size_t m_nBusyWorkers;
+  std::priority_queue<Job, std::vector<Job>, JobOrder> m_queue;
+  uint64_t m_nextSeq;
+  time::milliseconds m_queuedDuration; ///< processing time of waiting requests
+  ServiceStats m_stats;
 };
 
 int
 main(int argc, char* argv[])
 {
-  if (argc != 4) {
-    std::cerr << "USAGE: ./throttled-producer ndn:/name minThres maxThres" << std::endl;
+  if (argc != 4 && argc != 5) {
+    std::cerr << "USAGE: ./throttled-producer ndn:/name [red] minThres maxThres\n"
+                 "       ./throttled-producer ndn:/name codel targetMs intervalMs" << std::endl;
     return 1;
   }
 
   boost::asio::io_service io;
   StandaloneClientFace face(io);
   Scheduler scheduler(io);
-  RandomEarlyNack ren(boost::lexical_cast<size_t>(argv[2]), boost::lexical_cast<size_t>(argv[3]));
 
-  ThrottledProducer tp(face, scheduler, Name(argv[1]), ren);
+  unique_ptr<ActiveQueueManagement> aqm;
+  std::string aqmName = argc == 5 ? argv[2] : "red";
+  char** aqmArgs = argv + argc - 2;
+  if (aqmName == "red") {
+    aqm.reset(new RandomEarlyNack(boost::lexical_cast<size_t>(aqmArgs[0]),
+                                  boost::lexical_cast<size_t>(aqmArgs[1])));
+  }
+  else if (aqmName == "codel") {
+    aqm.reset(new CodelNack(time::milliseconds(boost::lexical_cast<int>(aqmArgs[0])),
+                            time::milliseconds(boost::lexical_cast<int>(aqmArgs[1]))));
+  }
+  else {
+    std::cerr << "unknown AQM policy " << aqmName << std::endl;
+    return 1;
+  }
+
+  size_t nSigningWorkers = 0;
+  Name signingIdentity = SigningPool::DIGEST_SHA256;
+  if (getenv("SIGNING_WORKERS") != nullptr) {
+    nSigningWorkers = boost::lexical_cast<size_t>(getenv("SIGNING_WORKERS"));
+  }
+  if (getenv("SIGNING_IDENTITY") != nullptr) {
+    signingIdentity = Name(getenv("SIGNING_IDENTITY"));
+  }
+  SigningPool signingPool(io, nSigningWorkers, signingIdentity);
+  face.signingPool = &signingPool;
+  face.shouldEncodeNackAsLpPacket = getenv("NACK_RETRY_AFTER") != nullptr;
+
+  size_t nWorkers = 1;
+  if (getenv("SERVICE_WORKERS") != nullptr) {
+    int n = 0;
+    try {
+      n = boost::lexical_cast<int>(getenv("SERVICE_WORKERS"));
+    }
+    catch (const boost::bad_lexical_cast&) {
+    }
+    if (n <= 0) {
+      std::cerr << "SERVICE_WORKERS must be a positive integer" << std::endl;
+      return 1;
+    }
+    nWorkers = n;
+  }
+  ThrottledProducer::Discipline discipline = ThrottledProducer::DISCIPLINE_FIFO;
+  if (getenv("SERVICE_DISCIPLINE") != nullptr &&
+      std::string(getenv("SERVICE_DISCIPLINE")) == "sjf") {
+    discipline = ThrottledProducer::DISCIPLINE_SJF;
+  }
+  time::seconds statsInterval(10);
+  if (getenv("STATS_INTERVAL") != nullptr) {
+    statsInterval = time::seconds(boost::lexical_cast<int>(getenv("STATS_INTERVAL")));
+  }
+
+  LOG("AQM " << aqm->getName() << " workers=" << nWorkers);
+  ThrottledProducer tp(face, scheduler, Name(argv[1]), *aqm, nWorkers, discipline);
+  tp.startReporting(statsInterval);
   io.run();
 
   return 0;
 }
 
-} // namespace ndn
 } // namespace throttled_producer
+} // namespace ndn
+
+#ifndef NO_MAIN
 
 int
 main(int argc, char* argv[])
 {
   return ndn::throttled_producer::main(argc, argv);
 }
+
+#endif // NO_MAIN
@@ -0,0 +1,128 @@
+/**
+ *  udp-send-benchmark compares two ways to send a header and a payload in one datagram.
+ *
+ *  "concat" copies header and payload into a new buffer and sends it as one Block;
+ *  "gather" passes both Blocks to UdpTransport::send(header, payload).
+ *  The header is the TLV-TYPE and TLV-LENGTH of an element enclosing the payload,
+ *  as a link protocol would prepend. The time to issue nPackets sends is reported,
+ *  as well as how many packets arrive at a receiver.
+ *
+ *  Usage: udp-send-benchmark [nPackets] [payloadSize] [batchSize]
+ */
+
+#include "transport/udp-transport.hpp"
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace ndn {
+namespace udp_send_benchmark {
+
+static const size_t BURST_SIZE = 64;
+static const uint32_t HEADER_TYPE = 100;
+
+static void
+runBenchmark(const std::string& mode, size_t nPackets, size_t payloadSize, size_t batchSize)
+{
+  boost::asio::io_service io;
+  UdpTransport sender(ndn::util::FaceUri("udp4://127.0.0.1:6366"), 6365);
+  UdpTransport receiver(ndn::util::FaceUri("udp4://127.0.0.1:6365"), 6366);
+  sender.batchSize = receiver.batchSize = batchSize;
+
+  size_t nReceived = 0;
+  boost::asio::deadline_timer idleTimer(io);
+  std::function<void()> restartIdleTimer = [&] {
+    idleTimer.expires_from_now(boost::posix_time::milliseconds(500));
+    idleTimer.async_wait([&io] (const boost::system::error_code& ec) {
+      if (!ec) {
+        io.stop();
+      }
+    });
+  };
+
+  sender.connect(io, bind([]{}));
+  receiver.connect(io, [&] (const Block&) {
+    if (++nReceived == nPackets) {
+      io.stop();
+    }
+    else if (nReceived % BURST_SIZE == 0) {
+      restartIdleTimer();
+    }
+  });
+
+  std::vector<uint8_t> payloadValue(payloadSize);
+  Block payload = makeBinaryBlock(tlv::Content, payloadValue.data(), payloadValue.size());
+  EncodingBuffer encoder;
+  encoder.prependVarNumber(payload.size());
+  encoder.prependVarNumber(HEADER_TYPE);
+  Block header = encoder.block(false);
+
+  bool isGather = mode == "gather";
+  size_t nSent = 0;
+  time::nanoseconds sendDuration(0);
+  std::function<void()> sendBurst = [&] {
+    time::steady_clock::TimePoint t0 = time::steady_clock::now();
+    for (size_t i = 0; i < BURST_SIZE && nSent < nPackets; ++i, ++nSent) {
+      if (isGather) {
+        sender.send(header, payload);
+      }
+      else {
+        auto buffer = make_shared<Buffer>(header.size() + payload.size());
+        std::copy(header.wire(), header.wire() + header.size(), buffer->begin());
+        std::copy(payload.wire(), payload.wire() + payload.size(),
+                  buffer->begin() + header.size());
+        sender.send(Block(buffer));
+      }
+    }
+    sendDuration += time::steady_clock::now() - t0;
+    if (nSent < nPackets) {
+      io.post(sendBurst);
+    }
+  };
+  io.post(sendBurst);
+  restartIdleTimer();
+
+  time::steady_clock::TimePoint t0 = time::steady_clock::now();
+  io.run();
+  time::steady_clock::TimePoint t1 = time::steady_clock::now();
+  double seconds = time::duration_cast<time::microseconds>(t1 - t0).count() / 1000000.0;
+
+  std::cout << mode << " batchSize=" << batchSize
+            << " send=" << time::duration_cast<time::nanoseconds>(sendDuration).count() / nPackets
+            << "ns/packet"
+            << " received=" << nReceived << "/" << nPackets
+            << " rate=" << static_cast<uint64_t>(nReceived / seconds) << "pps" << std::endl;
+
+  sender.close();
+  receiver.close();
+}
+
+int
+main(int argc, char* argv[])
+{
+  size_t nPackets = 1000000;
+  size_t payloadSize = 1000;
+  size_t batchSize = 1;
+  if (argc > 1) {
+    nPackets = boost::lexical_cast<size_t>(argv[1]);
+  }
+  if (argc > 2) {
+    payloadSize = boost::lexical_cast<size_t>(argv[2]);
+  }
+  if (argc > 3) {
+    batchSize = boost::lexical_cast<size_t>(argv[3]);
+  }
+
+  runBenchmark("concat", nPackets, payloadSize, batchSize);
+  runBenchmark("gather", nPackets, payloadSize, batchSize);
+  return 0;
+}
+
+} // namespace udp_send_benchmark
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::udp_send_benchmark::main(argc, argv);
+}
@@ -0,0 +1,121 @@
+/**
+ *  udp-transport-benchmark measures UdpTransport throughput over loopback.
+ *
+ *  A sender transport sends nPackets Blocks in bursts of 64 per io_service turn,
+ *  and a receiver transport counts them. The run ends when all packets arrive,
+ *  or when no packet arrives for 500ms. The same workload is run with each batch size.
+ *
+ *  Usage: udp-transport-benchmark [nPackets] [payloadSize] [batchSize...]
+ */
+
+#include "transport/udp-transport.hpp"
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace ndn {
+namespace udp_transport_benchmark {
+
+static const size_t BURST_SIZE = 64;
+
+static void
+runBenchmark(size_t batchSize, size_t nPackets, size_t payloadSize)
+{
+  boost::asio::io_service io;
+  UdpTransport sender(ndn::util::FaceUri("udp4://127.0.0.1:6364"), 6363);
+  UdpTransport receiver(ndn::util::FaceUri("udp4://127.0.0.1:6363"), 6364);
+  sender.batchSize = receiver.batchSize = batchSize;
+
+  size_t nReceived = 0;
+  boost::asio::deadline_timer idleTimer(io);
+  std::function<void()> restartIdleTimer = [&] {
+    idleTimer.expires_from_now(boost::posix_time::milliseconds(500));
+    idleTimer.async_wait([&io] (const boost::system::error_code& ec) {
+      if (!ec) {
+        io.stop();
+      }
+    });
+  };
+
+  sender.connect(io, bind([]{}));
+  receiver.connect(io, [&] (const Block&) {
+    if (++nReceived == nPackets) {
+      io.stop();
+    }
+    else if (nReceived % BURST_SIZE == 0) {
+      restartIdleTimer();
+    }
+  });
+
+  std::vector<uint8_t> payload(payloadSize);
+  Block block = makeBinaryBlock(tlv::Content, payload.data(), payload.size());
+
+  size_t nSent = 0;
+  std::function<void()> sendBurst = [&] {
+    for (size_t i = 0; i < BURST_SIZE && nSent < nPackets; ++i, ++nSent) {
+      sender.send(block);
+    }
+    if (nSent < nPackets) {
+      io.post(sendBurst);
+    }
+  };
+  io.post(sendBurst);
+  restartIdleTimer();
+
+  time::steady_clock::TimePoint t0 = time::steady_clock::now();
+  io.run();
+  time::steady_clock::TimePoint t1 = time::steady_clock::now();
+  double seconds = time::duration_cast<time::microseconds>(t1 - t0).count() / 1000000.0;
+
+  const UdpTransport::BatchCounters& sendCounters = sender.getBatchCounters();
+  const UdpTransport::BatchCounters& recvCounters = receiver.getBatchCounters();
+  std::cout << "batchSize=" << batchSize
+            << " received=" << nReceived << "/" << nPackets
+            << " rate=" << static_cast<uint64_t>(nReceived / seconds) << "pps";
+  if (batchSize > 1) {
+    std::cout << " avgSendBatch="
+              << static_cast<double>(sendCounters.nSendDatagrams) /
+                 std::max<uint64_t>(sendCounters.nSendBatches, 1)
+              << " avgRecvBatch="
+              << static_cast<double>(recvCounters.nRecvDatagrams) /
+                 std::max<uint64_t>(recvCounters.nRecvBatches, 1)
+              << " maxRecvBatch=" << recvCounters.maxRecvBatch;
+  }
+  std::cout << std::endl;
+
+  sender.close();
+  receiver.close();
+}
+
+int
+main(int argc, char* argv[])
+{
+  size_t nPackets = 1000000;
+  size_t payloadSize = 100;
+  std::vector<size_t> batchSizes;
+  if (argc > 1) {
+    nPackets = boost::lexical_cast<size_t>(argv[1]);
+  }
+  if (argc > 2) {
+    payloadSize = boost::lexical_cast<size_t>(argv[2]);
+  }
+  for (int i = 3; i < argc; ++i) {
+    batchSizes.push_back(boost::lexical_cast<size_t>(argv[i]));
+  }
+  if (batchSizes.empty()) {
+    batchSizes = {1, 8, 32, 64};
+  }
+
+  for (size_t batchSize : batchSizes) {
+    runBenchmark(batchSize, nPackets, payloadSize);
+  }
+  return 0;
+}
+
+} // namespace udp_transport_benchmark
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::udp_transport_benchmark::main(argc, argv);
+}